@@ -0,0 +1,99 @@
+#include "Bitboard.h"
+#include "Magic.h"
+#include "Psqt.h"
+#include "Zobrist.h"
+
+Bitboard knightAttacksTable[64];
+Bitboard kingAttacksTable[64];
+Bitboard pawnAttacksTable[2][64];
+Bitboard rayTable[8][64];
+Bitboard betweenTable[64][64];
+Bitboard lineTable[64][64];
+
+// ray steps as (file, rank), in Direction order
+
+static const int rayDelta[8][2] = { {0, 1}, {1, 1}, {1, 0}, {-1, 1}, {0, -1}, {-1, -1}, {-1, 0}, {1, -1} };
+
+// Table Construction
+
+static bool isOnBoard(int file, int rank)
+{
+	return file >= 0 && file < 8 && rank >= 0 && rank < 8;
+}
+
+static Bitboard stepAttacks(Square s, const int delta[][2], int count)
+{
+	Bitboard attacks = 0;
+
+	for (int k = 0; k < count; ++k)
+	{
+		int file = fileOf(s) + delta[k][0];
+		int rank = rankOf(s) + delta[k][1];
+
+		if (isOnBoard(file, rank))
+			attacks |= squareBB(makeSquare(file, rank));
+	}
+
+	return attacks;
+}
+
+static void initTables()
+{
+	static const int knightDelta[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+	static const int whitePawnDelta[2][2] = { {-1, 1}, {1, 1} };
+	static const int blackPawnDelta[2][2] = { {-1, -1}, {1, -1} };
+
+	for (int i = 0; i < 64; ++i)
+	{
+		Square s = Square(i);
+
+		knightAttacksTable[s] = stepAttacks(s, knightDelta, 8);
+		kingAttacksTable[s] = stepAttacks(s, rayDelta, 8);
+		pawnAttacksTable[white][s] = stepAttacks(s, whitePawnDelta, 2);
+		pawnAttacksTable[black][s] = stepAttacks(s, blackPawnDelta, 2);
+
+		for (int dir = 0; dir < 8; ++dir)
+		{
+			rayTable[dir][s] = 0;
+
+			int file = fileOf(s) + rayDelta[dir][0];
+			int rank = rankOf(s) + rayDelta[dir][1];
+
+			while (isOnBoard(file, rank))
+			{
+				rayTable[dir][s] |= squareBB(makeSquare(file, rank));
+				file += rayDelta[dir][0];
+				rank += rayDelta[dir][1];
+			}
+		}
+	}
+
+	for (int i = 0; i < 64; ++i)
+	{
+		Square s = Square(i);
+
+		for (int dir = 0; dir < 8; ++dir)
+		{
+			Bitboard ray = rayTable[dir][s];
+			Bitboard fullLine = ray | rayTable[(dir + 4) % 8][s] | squareBB(s);		// opposite direction is four steps along
+
+			for (Bitboard b = ray; b; )
+			{
+				Square t = popLsb(b);
+				betweenTable[s][t] = ray & ~rayTable[dir][t] & ~squareBB(t);
+				lineTable[s][t] = fullLine;
+			}
+		}
+	}
+
+	initMagics();			// slider tables are built from the rays above
+	initZobrist();
+	initPsqt();
+}
+
+void initBitboards()
+{
+	static const bool initialized = (initTables(), true);		// function local static makes this thread safe and run once
+	(void)initialized;
+}
+
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+typedef uint64_t Bitboard;
+
+enum Color { white, black };
+
+// piece type codes match the values returned by Position::pieceAt(), pos for white, neg for black
+enum PieceType { noPieceType, king, queen, rook, bishop, knight, pawn };
+
+enum Square : int
+{
+	a1, b1, c1, d1, e1, f1, g1, h1,
+	a2, b2, c2, d2, e2, f2, g2, h2,
+	a3, b3, c3, d3, e3, f3, g3, h3,
+	a4, b4, c4, d4, e4, f4, g4, h4,
+	a5, b5, c5, d5, e5, f5, g5, h5,
+	a6, b6, c6, d6, e6, f6, g6, h6,
+	a7, b7, c7, d7, e7, f7, g7, h7,
+	a8, b8, c8, d8, e8, f8, g8, h8,
+	noSquare
+};
+
+// ray directions, the first four point towards higher square indices
+
+enum Direction { north, northEast, east, northWest, south, southWest, west, southEast };
+
+const Bitboard fileABB = 0x0101010101010101ULL;
+const Bitboard fileHBB = fileABB << 7;
+const Bitboard rank1BB = 0xFFULL;
+const Bitboard rank8BB = rank1BB << 56;
+const Bitboard darkSquaresBB = 0xAA55AA55AA55AA55ULL;		// a1, c1, ..., b2, d2, ...
+
+// Squares
+
+inline Square makeSquare(int file, int rank)	{ return Square(rank * 8 + file); }
+inline int fileOf(Square s)						{ return s & 7; }
+inline int rankOf(Square s)						{ return s >> 3; }
+inline Bitboard squareBB(Square s)				{ return 1ULL << s; }
+
+// Bit Manipulation
+
+inline int popCount(Bitboard b)
+{
+#ifdef _MSC_VER
+	return int(__popcnt64(b));
+#else
+	return __builtin_popcountll(b);
+#endif
+}
+
+inline Square lsb(Bitboard b)					// index of least significant set bit, b must not be empty
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, b);
+	return Square(index);
+#else
+	return Square(__builtin_ctzll(b));
+#endif
+}
+
+inline Square msb(Bitboard b)					// index of most significant set bit, b must not be empty
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, b);
+	return Square(index);
+#else
+	return Square(63 ^ __builtin_clzll(b));
+#endif
+}
+
+inline Square popLsb(Bitboard& b)				// removes and returns least significant set bit
+{
+	Square s = lsb(b);
+	b &= b - 1;
+	return s;
+}
+
+// Attack Tables
+
+extern Bitboard knightAttacksTable[64];
+extern Bitboard kingAttacksTable[64];
+extern Bitboard pawnAttacksTable[2][64];
+extern Bitboard rayTable[8][64];				// squares in each direction from a square, up to the board edge
+extern Bitboard betweenTable[64][64];			// squares strictly between two aligned squares, empty otherwise
+extern Bitboard lineTable[64][64];				// whole line through two aligned squares, empty otherwise
+
+void initBitboards();							// builds the attack, hash and evaluation tables once, safe to call repeatedly
+
+inline Bitboard knightAttacks(Square s)			{ return knightAttacksTable[s]; }
+inline Bitboard kingAttacks(Square s)			{ return kingAttacksTable[s]; }
+inline Bitboard pawnAttacks(Color c, Square s)	{ return pawnAttacksTable[c][s]; }
+inline Bitboard between(Square a, Square b)		{ return betweenTable[a][b]; }
+inline Bitboard line(Square a, Square b)		{ return lineTable[a][b]; }
@@ -1,6 +1,10 @@
 #include "Board.h"
+#include <cmath>
+#include <fstream>
 #include <iostream>			// for std::cerr
-#include <sstream>
+
+const unsigned int notationSize = 16;		// character size of the algebraic notation
+const unsigned int labelSize = 15;			// character size of the square labels
 
 std::ostream& operator<<(std::ostream& stream, const IntPairVec& vec)
 {
@@ -12,11 +16,126 @@ std::ostream& operator<<(std::ostream& stream, const IntPairVec& vec)
 	return stream;
 }
 
+// ------------------------------------------- VERTEX BATCHES -------------------------------------------
+
+// Each layer of the board is kept as a list of triangles so it reaches the GPU in a single draw call.
+
+static void appendQuad(sf::VertexArray& batch, const sf::FloatRect& rect, const sf::Color& color, const sf::FloatRect& texRect = sf::FloatRect())
+{
+	sf::Vector2f corners[4] =
+	{
+		sf::Vector2f(rect.left, rect.top), sf::Vector2f(rect.left + rect.width, rect.top),
+		sf::Vector2f(rect.left + rect.width, rect.top + rect.height), sf::Vector2f(rect.left, rect.top + rect.height)
+	};
+
+	sf::Vector2f coords[4] =
+	{
+		sf::Vector2f(texRect.left, texRect.top), sf::Vector2f(texRect.left + texRect.width, texRect.top),
+		sf::Vector2f(texRect.left + texRect.width, texRect.top + texRect.height), sf::Vector2f(texRect.left, texRect.top + texRect.height)
+	};
+
+	for (int k : { 0, 1, 2, 0, 2, 3 })
+		batch.append(sf::Vertex(corners[k], color, coords[k]));
+}
+
+static void appendPolygon(sf::VertexArray& batch, const std::vector<sf::Vector2f>& points, const sf::Color& color)
+{
+	for (size_t k = 1; k + 1 < points.size(); ++k)		// fan around the first point, polygon must be convex
+	{
+		batch.append(sf::Vertex(points[0], color));
+		batch.append(sf::Vertex(points[k], color));
+		batch.append(sf::Vertex(points[k + 1], color));
+	}
+}
+
+static void appendOutline(sf::VertexArray& batch, const std::vector<sf::Vector2f>& outer, const std::vector<sf::Vector2f>& inner, const sf::Color& color)
+{
+	for (size_t k = 0; k < outer.size(); ++k)			// band between two polygons with the same number of points
+	{
+		size_t next = (k + 1) % outer.size();
+		appendPolygon(batch, { outer[k], outer[next], inner[next], inner[k] }, color);
+	}
+}
+
+static std::vector<sf::Vector2f> regularPolygon(const sf::Vector2f& position, const float& radius, const size_t& pointCount, const float& inset = 0)
+{
+	// same points as sf::CircleShape(radius, pointCount) placed at position, moved inset pixels towards the center
+
+	const float pi = 3.141592654f;
+	std::vector<sf::Vector2f> points(pointCount);
+
+	for (size_t k = 0; k < pointCount; ++k)
+	{
+		float angle = k * 2 * pi / pointCount - pi / 2;
+		points[k] = sf::Vector2f(position.x + radius + std::cos(angle) * (radius - inset), position.y + radius + std::sin(angle) * (radius - inset));
+	}
+
+	return points;
+}
+
+static sf::FloatRect textBounds(const sf::Font& font, const unsigned int& size, const std::string& string, const float& outlineThickness = 0)
+{
+	// local bounds of a single line of text, as sf::Text::getLocalBounds() would report them
+
+	float x = 0;
+	float y = float(size);
+	float minX = float(size), minY = float(size), maxX = 0, maxY = 0;
+	sf::Uint32 previous = 0;
+
+	for (char c : string)
+	{
+		sf::Uint32 current = static_cast<unsigned char>(c);
+		x += font.getKerning(previous, current, size);
+		previous = current;
+
+		const sf::Glyph& glyph = font.getGlyph(current, size, false);
+
+		if (c != ' ')
+		{
+			minX = std::min(minX, x + glyph.bounds.left);
+			minY = std::min(minY, y + glyph.bounds.top);
+			maxX = std::max(maxX, x + glyph.bounds.left + glyph.bounds.width);
+			maxY = std::max(maxY, y + glyph.bounds.top + glyph.bounds.height);
+		}
+
+		x += glyph.advance;
+	}
+
+	return sf::FloatRect(minX - outlineThickness, minY - outlineThickness, maxX - minX + 2 * outlineThickness, maxY - minY + 2 * outlineThickness);
+}
+
+static void appendText(sf::VertexArray& batch, const sf::Font& font, const unsigned int& size, const std::string& string, const sf::Vector2f& position, const sf::Color& color, const float& outlineThickness = 0)
+{
+	// glyph quads laid out like sf::Text at position, outline glyphs if outlineThickness is set
+
+	const float padding = 1.0f;							// sf::Text pads glyphs so smoothed edges are not cut off
+	float x = 0;
+	float y = float(size);
+	sf::Uint32 previous = 0;
+
+	for (char c : string)
+	{
+		sf::Uint32 current = static_cast<unsigned char>(c);
+		x += font.getKerning(previous, current, size);
+		previous = current;
+
+		if (c != ' ')
+		{
+			const sf::Glyph& glyph = font.getGlyph(current, size, false, outlineThickness);
+			sf::FloatRect rect(position.x + x + glyph.bounds.left - padding, position.y + y + glyph.bounds.top - padding, glyph.bounds.width + 2 * padding, glyph.bounds.height + 2 * padding);
+			sf::FloatRect texRect(glyph.textureRect.left - padding, glyph.textureRect.top - padding, glyph.textureRect.width + 2 * padding, glyph.textureRect.height + 2 * padding);
+			appendQuad(batch, rect, color, texRect);
+		}
+
+		x += font.getGlyph(current, size, false).advance;
+	}
+}
+
 // ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
 
 // Constructor
 
-Board::Board(const boardThemes& boardTheme, const std::string& piecesTheme)
+Board::Board(const boardThemes& boardTheme, const std::string& piecesTheme) : textures("../Resources/Textures/"), pieceAtlas("../Resources/Pieces/")
 {
 	srand(static_cast<unsigned int>(time(NULL)));
 	rgbTime = 100;
@@ -24,13 +143,10 @@ Board::Board(const boardThemes& boardTheme, const std::string& piecesTheme)
 	rgbColor = HSV2RGB(hsvColor);
 
 	squareSize = 64.0f;
-	checkmate = false;
-	stalemate = false;
 	facingWhite = true;
 	moveAllowed = false;
 	movesVisible = false;
 	threatsVisible = false;
-	eSquarePos = sf::Vector2u(8, 8);
 
 	selectBoardTheme(boardTheme);
 	this->piecesTheme = piecesTheme;
@@ -39,6 +155,19 @@ Board::Board(const boardThemes& boardTheme, const std::string& piecesTheme)
 	leftNotation = true;
 	labelsVisible = false;
 
+	engineEnabled = false;
+	engineColor = black;
+	engineJob = 0;
+	engineThinking = false;
+
+	squareBatch.setPrimitiveType(sf::Triangles);
+	notationBatch.setPrimitiveType(sf::Triangles);
+	pieceBatch.setPrimitiveType(sf::Triangles);
+	labelBatch.setPrimitiveType(sf::Triangles);
+	overlayBatch.setPrimitiveType(sf::Triangles);
+	checkBatch.setPrimitiveType(sf::Triangles);
+	batchesDirty = true;
+
 	if (!notationFont.loadFromFile("../Resources/Fonts/Segoe UI Bold.ttf"))
 	{
 		std::cerr << "Fatal Error! Notation font not loaded! Board::Board()" << std::endl;
@@ -51,15 +180,15 @@ Board::Board(const boardThemes& boardTheme, const std::string& piecesTheme)
 		std::exit(EXIT_FAILURE);
 	}
 
-	if (!squareTexture.loadFromFile("../Resources/Textures/marble.jpg"))
+	if (!textures.loadAll())
+		std::cerr << "Error! Some textures are missing, plain colors are drawn instead! Board::Board()" << std::endl;
+
+	if (!pieceAtlas.get(piecesTheme))
 	{
-		std::cerr << "Fatal Error! Square texture not loaded! Board::Board()" << std::endl;
+		std::cerr << "Fatal Error! Pieces theme not loaded! Board::Board()" << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 
-	FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
-	//FEN = "rnbqkbnr/8/8/pppppppp/PPPPPPPP/8/8/RNBQKBNR w KQkq - 0 1";
-	loadFen();
 	getAllThreats();
 }
 
@@ -70,29 +199,33 @@ void Board::draw(sf::RenderWindow& window)
 {
 	if (boardTheme == boardThemes::rgb) updateColors();
 
-	sf::RectangleShape square(sf::Vector2f(squareSize, squareSize));
-	square.setTexture(&squareTexture);
+	if (batchesDirty)
+		rebuildBatches();
 
-	for (int i = 0; i < 8; ++i)
-	{
-		for (int j = 0; j < 8; ++j)
-		{
-			square.setFillColor(moveAllowed && i == hSquarePos.y && j == hSquarePos.x ? hColor : (i + j) % 2 ? bColor : wColor);
-			square.setPosition(j * squareSize, i * squareSize);
-			window.draw(square);
+	window.draw(squareBatch, &textures.get(boardTextures::marble));
+	window.draw(checkBatch, &textures.get(boardTextures::invertedGrey));
+
+	window.draw(notationBatch, &notationFont.getTexture(notationSize));
+	window.draw(pieceBatch, &pieceAtlas.get(piecesTheme)->texture);
+	window.draw(labelBatch, &labelFont.getTexture(labelSize));
+	window.draw(overlayBatch);
+}
 
-			if (White.inCheck && board[i][j] == 1 || Black.inCheck && board[i][j] == -1)
-				drawCheck(i, j, window);
 
-			if (notationVisible)	drawNotation(i, j, window);
-			if (piecesVisible)		drawPiece(i, j, window);
-			if (labelsVisible)		drawLabels(i, j, window);
-		}
-	}
+// Redrawing
+
+bool Board::isAnimating() const
+{
+	return boardTheme == boardThemes::rgb || engineThinking;
+}
+
+bool Board::needsRedraw()
+{
+	if (engineThinking) pollEngine();
 
-	if (movesVisible) drawMoves(window);
+	if (boardTheme == boardThemes::rgb) updateColors();
 
-	if (threatsVisible) drawThreats(window);
+	return batchesDirty;
 }
 
 
@@ -112,14 +245,15 @@ void Board::resize(sf::View& view, const float& viewLength, const sf::Vector2u&
 
 void Board::movePiece(const sf::Vector2i& mousePos, const sf::Vector2u& windowSize, const bool& isMousePressed)
 {
-	if (isMousePressed && !checkmate && !stalemate)											// if holding down mouse
+	if (isMousePressed && game.getResult() == gameResults::ongoing)							// if holding down mouse
 	{
 		hSquarePos = getMouseSquare(mousePos, windowSize);									// find position of selected square
 		availableMoves.clear();																// clear the list of available moves
 
-		if (board[hSquarePos.y][hSquarePos.x] &&											// clicked square is not empty
-			whiteToMove && board[hSquarePos.y][hSquarePos.x] > 0 ||							// only white pieces move on white turn
-			!whiteToMove && board[hSquarePos.y][hSquarePos.x] < 0)							// only black pieces move on black turn
+		int piece = hSquarePos.x < 8 && hSquarePos.y < 8 ? pieceAt(hSquarePos.y, hSquarePos.x) : 0;
+		bool whiteToMove = game.getPosition().sideToMove() == white;
+
+		if (piece && whiteToMove == (piece > 0) && !enginesTurn())						// only pieces of the side to move can be picked up
 		{
 			moveAllowed = true;																// highlight selected square if appropriate
 			availableMoves = getPieceMoves(hSquarePos.y, hSquarePos.x);						// get list of moves
@@ -134,51 +268,20 @@ void Board::movePiece(const sf::Vector2i& mousePos, const sf::Vector2u& windowSi
 
 		sf::Vector2u newSquarePos = getMouseSquare(mousePos, windowSize);					// get destination square
 
-		for (auto it = availableMoves.begin(); it != availableMoves.end(); ++it)			// loop over all available moves
+		if (existsInVec(IntPair(newSquarePos.x, newSquarePos.y), availableMoves))			// if making a legal move
 		{
-			if (newSquarePos.x == it->first && newSquarePos.y == it->second)				// if making a legal move
-			{
-				// special moves
-
-				bool enPassantPlayed = false;
-				bool castlingPlayed = false;
-
-				if (isKing(hSquarePos.y, hSquarePos.x) && existsInVec(*it, castlingSquares))
-				{
-					castle(hSquarePos, newSquarePos);
-					castlingPlayed = true;
-				}
-
-				if (isPawn(hSquarePos.y, hSquarePos.x) && eSquarePos == sf::Vector2u(it->first, it->second))
-				{
-					enPassant(hSquarePos, newSquarePos);
-					enPassantPlayed = true;
-				}
-
-				setEnPassantSquare(hSquarePos, newSquarePos);
-				updateCastlingStatus(hSquarePos, newSquarePos);
-
-				// normal moves
-
-				if (!enPassantPlayed && !castlingPlayed)
-				{
-					if (existsInVec(*it, promotionSquares))
-						promotePawn(hSquarePos, newSquarePos);
-					else
-						makeMove(hSquarePos, newSquarePos);
-				}
-
-				saveMove(hSquarePos, newSquarePos);											// save move to list of playedMoves
-				hSquarePos = getMouseSquare(mousePos, windowSize);							// hSquare set to destination square
-				moveAllowed = true;															// set to true to highlight new square
-				whiteToMove = !whiteToMove;													// change turns
-				getAllThreats();															// find all threats for other player
-				checkGameEnd();																// check for checkmate or stalemate
-			}
+			Square from = toSquare(hSquarePos.y, hSquarePos.x);
+			Square to = toSquare(newSquarePos.y, newSquarePos.x);
+			bool promotion = abs(pieceAt(hSquarePos.y, hSquarePos.x)) == pawn && (rankOf(to) == 0 || rankOf(to) == 7);
+			Move move(from, to, promotion ? queen : noPieceType);							// pawn promotion results in automatic queen
+
+			playMove(move);																	// castling, en passant and promotion are handled by the game
 		}
 
 		movesVisible = false;																// stop displaying available moves after piece has been moved
 	}
+
+	batchesDirty = true;
 }
 
 
@@ -186,20 +289,18 @@ void Board::movePiece(const sf::Vector2i& mousePos, const sf::Vector2u& windowSi
 
 void Board::flip()
 {
-	facingWhite = !facingWhite;
-
-	for (int i = 0; i < 4; ++i)
-		for (int j = 0; j < 8; ++j)
-			std::swap(board[i][j], board[7 - i][7 - j]);			// swap the pieces
+	facingWhite = !facingWhite;										// pieces are looked up through toSquare(), which considers the flip
 
 	hSquarePos = sf::Vector2u(7, 7) - hSquarePos;
-	eSquarePos = sf::Vector2u(7, 7) - eSquarePos;
 
 	for (size_t i = 0; i < availableMoves.size(); ++i)					// also change the list of moves if board is flipped
 	{
 		availableMoves[i].first = 7 - availableMoves[i].first;
 		availableMoves[i].second = 7 - availableMoves[i].second;
 	}
+
+	getAllThreats();												// threat squares are stored in screen coordinates
+	batchesDirty = true;
 }
 
 void Board::rgbBoardTheme()
@@ -214,166 +315,59 @@ void Board::randomBoardTheme()
 
 void Board::randomPieceTheme()
 {
-	piecesTheme = pieceSets[randomSet];
+	const char* theme = pieceSets[randomSet];
+
+	if (pieceAtlas.get(theme))						// read from disk only the first time a theme is picked
+		piecesTheme = theme;
+
+	batchesDirty = true;
 }
 
 void Board::togglePieceVisibilty()
 {
 	piecesVisible = !piecesVisible;
+	batchesDirty = true;
 }
 
 void Board::toggleLabelsVisibility()
 {
 	labelsVisible = !labelsVisible;
+	batchesDirty = true;
 }
 
 void Board::toggleThreatsVisibility()
 {
 	threatsVisible = !threatsVisible;
+	batchesDirty = true;
 }
 
 void Board::toggleNotationVisibility()
 {
 	notationVisible = !notationVisible;
+	batchesDirty = true;
 }
 
 void Board::toggleNotationAlignment()
 {
 	leftNotation = !leftNotation;
+	batchesDirty = true;
 }
 
-
-// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
-
-// FEN
-
-void Board::loadFen()
-{
-	std::istringstream iss(FEN);
-	std::string str;
-
-	getline(iss, str, ' ');
-	loadPieces(str);
-
-	getline(iss, str, ' ');
-	loadActiveColor(str);
-
-	getline(iss, str, ' ');
-	loadCastlingRights(str);
-
-	getline(iss, str, ' ');
-	loadEnPassantTarget(str);
-
-	getline(iss, str, ' ');
-	halfMoves = intFromStr(str);
-
-	getline(iss, str, ' ');
-	fullMoves = intFromStr(str);
-}
-
-void Board::loadPieces(const std::string& str)
+void Board::toggleEngine()
 {
-	int x = 0;		// square position on x axis
-	int y = 0;		// square position on y axis (flipped in SFML)
+	engineEnabled = !engineEnabled;
 
-	for (size_t i = 0; i < str.length(); ++i)
+	if (engineEnabled)
 	{
-		switch (str[i])
-		{
-		case '1':	case '2':	case '3':	case '4':	// empty spaces
-		case '5':	case '6':	case '7':	case '8':
-			for (int j = 0; j < str[i] - 48; ++j, ++x)	board[y][x] = 0;
-			break;
-		case 'K':	board[y][x] = 1;	White.kingPos = { x, y };	++x;	break;	// white King
-		case 'Q':	board[y][x] = 2;								++x;	break;	// white Queen
-		case 'R':	board[y][x] = 3;								++x;	break;	// white Rook
-		case 'B':	board[y][x] = 4;								++x;	break;	// white Bishop
-		case 'N':	board[y][x] = 5;								++x;	break;	// white kNight
-		case 'P':	board[y][x] = 6;								++x;	break;	// white Pawn
-		case 'k':	board[y][x] = -1;	Black.kingPos = { x, y };	++x;	break;	// black kING
-		case 'q':	board[y][x] = -2;								++x;	break;	// black qUEEN
-		case 'r':	board[y][x] = -3;								++x;	break;	// black rOOK
-		case 'b':	board[y][x] = -4;								++x;	break;	// black bISHOP
-		case 'n':	board[y][x] = -5;								++x;	break;	// black KnIGHT
-		case 'p':	board[y][x] = -6;								++x;	break;	// black pAWN
-		case '/':	x = 0;											++y;	break;	// next rank
-
-		default:
-			std::cerr << "Fatal Error! Invalid board position! Board::loadPosition()" << std::endl;
-			std::exit(EXIT_FAILURE);
-		}
+		engineColor = game.getPosition().sideToMove();		// the computer takes over the side to move
+		startEngine();
 	}
-}
-
-void Board::loadActiveColor(const std::string& str)
-{
-	if (str == "w")
-		whiteToMove = true;
-	else if (str == "b")
-		whiteToMove = false;
 	else
-	{
-		std::cerr << "Fatal Error! Invalid active color! Board::loadActiveColor()" << std::endl;
-		std::exit(EXIT_FAILURE);
-	}
-}
-
-void Board::loadCastlingRights(const std::string& str)
-{
-	if (str == "-")
-		return;
-
-	for (size_t i = 0; i < str.length(); ++i)
-	{
-		switch (str[i])
-		{
-		case 'K':
-			White.kingsideCastling = true;
-			break;
-		case 'Q':
-			White.queensideCastling = true;
-			break;
-		case 'k':
-			Black.kingsideCastling = true;
-			break;
-		case 'q':
-			Black.queensideCastling = true;
-			break;
-
-		default:
-			std::cerr << "Fatal Error! Invalid castling rights! Board::loadCastlingRights()" << std::endl;
-			std::exit(EXIT_FAILURE);
-		}
-	}
-}
-
-void Board::loadEnPassantTarget(const std::string& str)
-{
-	if (str == "-" || str.length() == 2 && str[0] >= 'a' && str[0] <= 'h' && str[1] >= '1' && str[1] <= '8')
-	{
-		enPassantTarget = str;
-	}
-	else
-	{
-		std::cerr << "Fatal Error! Invalid En Passant target! Board::loadEnPassantTarget()" << std::endl;
-		std::exit(EXIT_FAILURE);
-	}
+		cancelEngine();
 }
 
-int Board::intFromStr(const std::string& str)
-{
-	for (size_t i = 0; i < str.length(); ++i)
-	{
-		if (str[i] < '0' || str[i] > '9')
-		{
-			std::cerr << "Fatal Error! String does not contain integers! Board::intFromStr()" << std::endl;
-			std::exit(EXIT_FAILURE);
-		}
-	}
-
-	return std::stoi(str);
-}
 
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
 
 // Themes
 
@@ -426,6 +420,8 @@ void Board::selectBoardTheme(const boardThemes& boardTheme)
 		std::cerr << "Fatal Error! Undefined board theme! Board::selectTheme()" << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+
+	batchesDirty = true;
 }
 
 
@@ -446,6 +442,7 @@ void Board::updateColors()
 
 		bColor = sf::Color(rgbColor.r, rgbColor.g, rgbColor.b, 255);
 		hColor = complementaryColor(bColor);
+		batchesDirty = true;
 	}
 }
 
@@ -548,9 +545,61 @@ sf::Color Board::complementaryColor(const sf::Color& color)
 }
 
 
-// Drawing
+// Batches
+
+void Board::rebuildBatches()
+{
+	squareBatch.clear();
+	checkBatch.clear();
+	notationBatch.clear();
+	pieceBatch.clear();
+	labelBatch.clear();
+	overlayBatch.clear();
+
+	buildSquares();
+	buildCheck();
+
+	if (notationVisible)	buildNotation();
+	if (piecesVisible)		buildPieces();
+	if (labelsVisible)		buildLabels();
+	if (movesVisible)		buildMoves();
+	if (threatsVisible)		buildThreats();
+
+	batchesDirty = false;
+}
+
+void Board::buildSquares()
+{
+	sf::Vector2u textureSize = textures.get(boardTextures::marble).getSize();
+	sf::FloatRect texRect(0, 0, float(textureSize.x), float(textureSize.y));		// whole texture on every square
+
+	for (int i = 0; i < 8; ++i)
+	{
+		for (int j = 0; j < 8; ++j)
+		{
+			sf::Color color = moveAllowed && i == hSquarePos.y && j == hSquarePos.x ? hColor : (i + j) % 2 ? bColor : wColor;
+			appendQuad(squareBatch, sf::FloatRect(j * squareSize, i * squareSize, squareSize, squareSize), color, texRect);
+		}
+	}
+}
+
+void Board::buildCheck()
+{
+	const Position& position = game.getPosition();
+
+	if (!position.inCheck())
+		return;
+
+	IntPair king = toPos(position.kingSquare(position.sideToMove()));
+
+	// Brainstorm -- checkered sphere texture ??
+	sf::Vector2u textureSize = textures.get(boardTextures::invertedGrey).getSize();
+	sf::FloatRect texRect(0, 0, float(textureSize.x), float(textureSize.y));
 
-void Board::drawMoves(sf::RenderWindow& window)
+	appendQuad(checkBatch, sf::FloatRect(king.first * squareSize, king.second * squareSize, squareSize, squareSize), hColor, texRect);
+}
+
+void Board::buildMoves()
 {
 	// color for outline
 	rgb rtemp = { hColor.r, hColor.g, hColor.b };
@@ -558,245 +607,155 @@ void Board::drawMoves(sf::RenderWindow& window)
 	htemp.s = 0.5;
 	htemp.v = 0.5;
 	rtemp = HSV2RGB(htemp);
+	sf::Color outlineColor(rtemp.r, rtemp.g, rtemp.b, 175);
 
-	sf::CircleShape circle(10.0f);
-	circle.setFillColor(hColor);
-	circle.setOutlineThickness(-2.0f);
-	circle.setOutlineColor(sf::Color(rtemp.r, rtemp.g, rtemp.b, 175));
+	const float outline = 2.0f;						// outline drawn inside the markers
+	const float radius = 10.0f;						// circle on empty squares
+	const float corner = squareSize / 4;			// legs of the triangles on captures
+	const float innerCorner = corner - outline * (2 + std::sqrt(2.0f));
 
-	sf::ConvexShape triangle(3);
-	triangle.setFillColor(circle.getFillColor());
-	triangle.setPoint(0, sf::Vector2f(0, 0));
-	triangle.setPoint(1, sf::Vector2f(squareSize / 4, 0));
-	triangle.setPoint(2, sf::Vector2f(0, squareSize / 4));
-	triangle.setOutlineThickness(-2.0f);
-	triangle.setOutlineColor(sf::Color(rtemp.r, rtemp.g, rtemp.b, 175));
+	sf::Vector2f corners[4] = { sf::Vector2f(0, 0), sf::Vector2f(squareSize, 0), sf::Vector2f(squareSize, squareSize), sf::Vector2f(0, squareSize) };
+
+	bool selectedPawn = abs(pieceAt(hSquarePos.y, hSquarePos.x)) == pawn;
 
 	for (auto it = availableMoves.begin(); it != availableMoves.end(); ++it)
 	{
-		// Problem: Square appears when piece other than pawn attacks in en passant
-		// Possible solution: get (i, j) as parameter and call isPieceCapture() function
+		bool enPassantCapture = selectedPawn && toSquare(it->second, it->first) == game.getPosition().enPassantSquare();
+		sf::Vector2f topLeft(it->first * squareSize, it->second * squareSize);
 
-		if (board[it->second][it->first] || eSquarePos == sf::Vector2u(it->first, it->second))		// if not empty square
+		if (pieceAt(it->second, it->first) || enPassantCapture)				// if not empty square
 		{
-			triangle.setPosition(it->first * squareSize, it->second * squareSize);	// top left
-			window.draw(triangle);
-
-			triangle.rotate(90);
-			triangle.move(squareSize, 0);		// top right
-			window.draw(triangle);
-
-			triangle.rotate(90);
-			triangle.move(0, squareSize);		// bottom right
-			window.draw(triangle);
+			for (int k = 0; k < 4; ++k)				// top left, top right, bottom right, bottom left
+			{
+				sf::Transform transform;
+				transform.translate(topLeft + corners[k]).rotate(90.0f * k);
 
-			triangle.rotate(90);
-			triangle.move(-squareSize, 0);		// bottom left
-			window.draw(triangle);
+				std::vector<sf::Vector2f> outer = { transform.transformPoint(0, 0), transform.transformPoint(corner, 0), transform.transformPoint(0, corner) };
+				std::vector<sf::Vector2f> inner = { transform.transformPoint(outline, outline), transform.transformPoint(outline + innerCorner, outline), transform.transformPoint(outline, outline + innerCorner) };
 
-			triangle.rotate(90);				// top left
+				appendPolygon(overlayBatch, outer, hColor);
+				appendOutline(overlayBatch, outer, inner, outlineColor);
+			}
 		}
 		else									// if empty square
 		{
-			circle.setPosition(it->first * squareSize, it->second * squareSize);
-			circle.move((squareSize - circle.getLocalBounds().width) / 2, (squareSize - circle.getLocalBounds().height) / 2);
-			window.draw(circle);
+			sf::Vector2f position = topLeft + sf::Vector2f(squareSize / 2 - radius, squareSize / 2 - radius);
+			std::vector<sf::Vector2f> outer = regularPolygon(position, radius, 30);
+			std::vector<sf::Vector2f> inner = regularPolygon(position, radius, 30, outline);
+
+			appendPolygon(overlayBatch, outer, hColor);
+			appendOutline(overlayBatch, outer, inner, outlineColor);
 		}
 	}
 }
 
-void Board::drawThreats(sf::RenderWindow& window)
+void Board::buildThreats()
 {
-	sf::CircleShape hexagon(32.0f, 6U);
-	hexagon.setFillColor(sf::Color(hColor.r, hColor.g, hColor.b, 100));
+	sf::Color color(hColor.r, hColor.g, hColor.b, 100);
 
 	for (auto it = allThreats.begin(); it != allThreats.end(); ++it)
-	{
-		hexagon.setPosition(it->first * squareSize, it->second * squareSize);
-		window.draw(hexagon);
-	}
+		appendPolygon(overlayBatch, regularPolygon(sf::Vector2f(it->first * squareSize, it->second * squareSize), 32.0f, 6), color);
 }
 
-void Board::drawCheck(const int& i, const int& j, sf::RenderWindow& window)
+void Board::buildPieces()
 {
-	// Brainstorm -- checkered sphere texture ??
-	sf::Texture checkTexture;
-	checkTexture.setSmooth(true);
+	const PieceSet* set = pieceAtlas.get(piecesTheme);		// already loaded, no disk access while drawing
 
-	if (!checkTexture.loadFromFile("../Resources/Textures/inverted_grey.png"))
+	for (int i = 0; i < 8; ++i)
 	{
-		std::cerr << "Fatal Error! Check texture not loaded! Board::drawCheck()" << std::endl;
-		std::exit(EXIT_FAILURE);
-	}
+		for (int j = 0; j < 8; ++j)
+		{
+			int pieceValue = pieceAt(i, j);
 
-	sf::RectangleShape check(sf::Vector2f(squareSize, squareSize));
-	check.setFillColor(hColor);
-	check.setTexture(&checkTexture);
-	check.setPosition(j * squareSize, i * squareSize);
-	window.draw(check);
+			if (pieceValue)							// skip empty squares
+				appendQuad(pieceBatch, sf::FloatRect(j * squareSize, i * squareSize, squareSize, squareSize), sf::Color::White, sf::FloatRect(set->getRect(pieceValue)));
+		}
+	}
 }
 
-void Board::drawPiece(const int& i, const int& j, sf::RenderWindow& window)
+void Board::buildLabels()
 {
-	std::string pieceType = "";
+	const float outline = 2.0f;
 
-	switch (board[i][j])
+	for (int i = 0; i < 8; ++i)
 	{
-	case 0:							return;	// empty square
-	case 1:		pieceType = "wK";	break;	// white King
-	case 2:		pieceType = "wQ";	break;	// white Queen
-	case 3:		pieceType = "wR";	break;	// white Rook
-	case 4:		pieceType = "wB";	break;	// white Bishop
-	case 5:		pieceType = "wN";	break;	// white kNight
-	case 6:		pieceType = "wP";	break;	// white Pawn
-	case -1:	pieceType = "bK";	break;	// black King
-	case -2:	pieceType = "bQ";	break;	// black Queen
-	case -3:	pieceType = "bR";	break;	// black Rook
-	case -4:	pieceType = "bB";	break;	// black Bishop
-	case -5:	pieceType = "bN";	break;	// black kNight
-	case -6:	pieceType = "bP";	break;	// black Pawn
-
-	default:
-		std::cerr << "Fatal Error! Undefined piece type! Board::drawPiece()" << std::endl;
-		std::exit(EXIT_FAILURE);
-	}
-
-	std::string texturePath = "../Resources/Pieces/" + piecesTheme + "/" + pieceType + ".png";
+		for (int j = 0; j < 8; ++j)
+		{
+			std::string label = std::to_string(i) + ", " + std::to_string(j);
+			sf::FloatRect labelRect = textBounds(labelFont, labelSize, label, outline);
+			sf::Vector2f position(j * squareSize + (squareSize - labelRect.width) / 2, i * squareSize + (squareSize - labelRect.height) / 2);
 
-	if (!piecesTexture.loadFromFile(texturePath))
-	{
-		std::cerr << "Fatal Error! Invalid texture path! Board::drawPiece()" << std::endl;
-		std::exit(EXIT_FAILURE);
+			appendText(labelBatch, labelFont, labelSize, label, position, sf::Color::Black, outline);		// outline below the text, like sf::Text
+			appendText(labelBatch, labelFont, labelSize, label, position, wColor);
+		}
 	}
-
-	sf::RectangleShape piece(sf::Vector2f(squareSize, squareSize));
-	piece.setPosition(j * squareSize, i * squareSize);
-	piece.setTexture(&piecesTexture);
-	window.draw(piece);
-}
-
-void Board::drawLabels(const int& i, const int& j, sf::RenderWindow& window)
-{
-	sf::Text label;
-	label.setFont(labelFont);
-	label.setCharacterSize(15);
-	label.setOutlineThickness(2.0f);
-	label.setFillColor(wColor);
-	label.setString(std::to_string(i) + ", " + std::to_string(j));
-	label.setPosition(j * squareSize, i * squareSize);
-	label.move((squareSize - label.getLocalBounds().width) / 2, (squareSize - label.getLocalBounds().height) / 2);
-	window.draw(label);
 }
 
-void Board::drawNotation(const int& i, const int& j, sf::RenderWindow& window)
+void Board::buildNotation()
 {
-	if (i != 7 && j != 0 && j != 7)
-		return;
-
-	sf::Text notation("", notationFont, 16);
-	notation.setFillColor((i + j) % 2 ? wColor : bColor);
-
-	char a = (facingWhite ? j : 7 - j) + 97;	// convert to ASCII alphabet, consider board flip
-	notation.setString(a);
+	for (int i = 0; i < 8; ++i)
+	{
+		for (int j = 0; j < 8; ++j)
+		{
+			if (i != 7 && j != 0 && j != 7)
+				continue;
 
-	sf::FloatRect notationRect = notation.getLocalBounds();
-	float xOffset = squareSize - notationRect.left - notationRect.width;
-	float yOffset = squareSize - notationRect.top - notationRect.height;
+			sf::Color color = (i + j) % 2 ? wColor : bColor;
 
-	if (i == 7)
-	{
-		if (leftNotation)
-			notation.setPosition(j * squareSize + xOffset, i * squareSize + yOffset);
-		else
-			notation.setPosition(j * squareSize, i * squareSize + yOffset);
+			std::string a(1, char((facingWhite ? j : 7 - j) + 97));		// convert to ASCII alphabet, consider board flip
+			std::string n(1, char((facingWhite ? 7 - i : i) + 49));		// convert to ASCII number, consider board flip
 
-		window.draw(notation);
-	}
+			sf::FloatRect notationRect = textBounds(notationFont, notationSize, a);
+			float xOffset = squareSize - notationRect.left - notationRect.width;
+			float yOffset = squareSize - notationRect.top - notationRect.height;
 
-	char n = (facingWhite ? 7 - i : i) + 49;	// convert to ASCII number, consider board flip
-	notation.setString(n);
+			if (i == 7)
+			{
+				if (leftNotation)
+					appendText(notationBatch, notationFont, notationSize, a, sf::Vector2f(j * squareSize + xOffset, i * squareSize + yOffset), color);
+				else
+					appendText(notationBatch, notationFont, notationSize, a, sf::Vector2f(j * squareSize, i * squareSize + yOffset), color);
+			}
 
-	if (leftNotation && j == 0)
-	{
-		notation.setPosition(j * squareSize, i * squareSize);
-		window.draw(notation);
-	}
+			if (leftNotation && j == 0)
+				appendText(notationBatch, notationFont, notationSize, n, sf::Vector2f(j * squareSize, i * squareSize), color);
 
-	if (!leftNotation && j == 7)
-	{
-		notation.setPosition(j * squareSize + xOffset, i * squareSize);
-		window.draw(notation);
+			if (!leftNotation && j == 7)
+				appendText(notationBatch, notationFont, notationSize, n, sf::Vector2f(j * squareSize + xOffset, i * squareSize), color);
+		}
 	}
 }
 
 
 // Squares
 
-char Board::getRank(const int& i)
+Square Board::toSquare(const int& i, const int& j)
 {
-	return (facingWhite ? 7 - i : i) + 49;		// convert to ASCII number
+	return facingWhite ? makeSquare(j, 7 - i) : makeSquare(7 - j, i);		// (i, j) on screen to bitboard square, consider board flip
 }
 
-char Board::getFile(const int& j)
+IntPair Board::toPos(const Square& square)
 {
-	return (facingWhite ? j : 7 - j) + 97;		// convert to ASCII alphabet
-}
-
-Squares Board::squareFromStr(const std::string& str)
-{
-	static const std::unordered_map<std::string, Squares> table =
-	{
-		{"a1", Squares::a1}, {"a2", Squares::a2}, {"a3", Squares::a3}, {"a4", Squares::a4}, {"a5", Squares::a5}, {"a6", Squares::a6}, {"a7", Squares::a7}, {"a8", Squares::a8},
-		{"b1", Squares::b1}, {"b2", Squares::b2}, {"b3", Squares::b3}, {"b4", Squares::b4}, {"b5", Squares::b5}, {"b6", Squares::b6}, {"b7", Squares::b7}, {"b8", Squares::b8},
-		{"c1", Squares::c1}, {"c2", Squares::c2}, {"c3", Squares::c3}, {"c4", Squares::c4}, {"c5", Squares::c5}, {"c6", Squares::c6}, {"c7", Squares::c7}, {"c8", Squares::c8},
-		{"d1", Squares::d1}, {"d2", Squares::d2}, {"d3", Squares::d3}, {"d4", Squares::d4}, {"d5", Squares::d5}, {"d6", Squares::d6}, {"d7", Squares::d7}, {"d8", Squares::d8},
-		{"e1", Squares::e1}, {"e2", Squares::e2}, {"e3", Squares::e3}, {"e4", Squares::e4}, {"e5", Squares::e5}, {"e6", Squares::e6}, {"e7", Squares::e7}, {"e8", Squares::e8},
-		{"f1", Squares::f1}, {"f2", Squares::f2}, {"f3", Squares::f3}, {"f4", Squares::f4}, {"f5", Squares::f5}, {"f6", Squares::f6}, {"f7", Squares::f7}, {"f8", Squares::f8},
-		{"g1", Squares::g1}, {"g2", Squares::g2}, {"g3", Squares::g3}, {"g4", Squares::g4}, {"g5", Squares::g5}, {"g6", Squares::g6}, {"g7", Squares::g7}, {"g8", Squares::g8},
-		{"h1", Squares::h1}, {"h2", Squares::h2}, {"h3", Squares::h3}, {"h4", Squares::h4}, {"h5", Squares::h5}, {"h6", Squares::h6}, {"h7", Squares::h7}, {"h8", Squares::h8},
-	};
-
-	auto it = table.find(str);
-
-	if (it != table.end())
-		return it->second;
+	if (facingWhite)
+		return IntPair(fileOf(square), 7 - rankOf(square));				// stored as (x, y) like the other square lists
 	else
-	{
-		std::cerr << "Fatal Error! String does not correspond to a square! squareFromStr()" << std::endl;
-		std::exit(EXIT_FAILURE);
-	}
-}
-
-Squares Board::squareFromPos(const sf::Vector2u& pos)
-{
-	std::string str = { getFile(pos.x), getRank(pos.y) };
-	return squareFromStr(str);
+		return IntPair(7 - fileOf(square), rankOf(square));
 }
 
-int Board::getValueAt(const Squares& square)
+IntPairVec Board::toPosVec(Bitboard squares)
 {
-	sf::Vector2u squarePos = getSquarePos(square);
-	return board[squarePos.y][squarePos.x];
-}
+	IntPairVec vec;
+	vec.reserve(popCount(squares));
 
-bool Board::isThreatened(const Squares& square)
-{
-	sf::Vector2u squarePos = getSquarePos(square);
+	while (squares)
+		vec.push_back(toPos(popLsb(squares)));
 
-	if (existsInVec(IntPair(squarePos.x, squarePos.y), allThreats))
-		return true;
-	else
-		return false;
+	return vec;
 }
 
-sf::Vector2u Board::getSquarePos(const Squares& square)
+int Board::pieceAt(const int& i, const int& j)
 {
-	sf::Vector2u squarePos = sf::Vector2u(int(square) % 8, int(square) / 8);
-
-	if (!facingWhite)
-		squarePos = sf::Vector2u(7, 7) - squarePos;
-
-	return squarePos;
+	return game.getPosition().pieceAt(toSquare(i, j));
 }
 
 
@@ -823,661 +782,227 @@ bool Board::existsInVec(const IntPair& val, const IntPairVec& vec)
 }
 
 
-// Pawn Functions
-
-bool Board::isPawn(const int& i, const int& j)
-{
-	return abs(board[i][j]) == 6;
-}
-
-bool Board::pawnMovingUp(const int& i, const int& j)
-{
-	if (facingWhite && board[i][j] == 6 || !facingWhite && board[i][j] == -6)
-		return true;
-	else
-		return false;
-}
-
-bool Board::pawnMovingDown(const int& i, const int& j)
-{
-	if (facingWhite && board[i][j] == -6 || !facingWhite && board[i][j] == 6)
-		return true;
-	else
-		return false;
-}
-
-
-// Pawn Promotion
-
-void Board::promotePawn(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
-{
-	int sign = board[oldPos.y][oldPos.x] / abs(board[oldPos.y][oldPos.x]);		// getting color of the pawn
-	board[newPos.y][newPos.x] = sign * 2;										// make a new queen
-	board[oldPos.y][oldPos.x] = 0;												// remove pawn from old position
-}
-
-void Board::setPromotionSquare(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
-{
-	if (oldPos.y == 1 && newPos.y == 0)							// pawn moves from second to first row
-		promotionSquares.push_back({ newPos.x, newPos.y });
-
-	if (oldPos.y == 6 && newPos.y == 7)							// pawn moves from seventh to eighth row
-		promotionSquares.push_back({ newPos.x, newPos.y });
-}
-
-
-// En Passant
-
-void Board::enPassant(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
-{
-	board[eSquarePos.y][eSquarePos.x] = board[oldPos.y][oldPos.x];		// add capturing pawn to en passant square
-	board[oldPos.y][oldPos.x] = 0;										// remove capturing pawn from old position
-	board[oldPos.y][newPos.x] = 0;										// remove the captured pawn
-}
-
-void Board::setEnPassantSquare(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
-{
-	eSquarePos = sf::Vector2u(8, 8);			// default dummy value overwritten if en passant possible, will never occur as out of board range
-
-	if (oldPos.y == 6 && newPos.y == 4 && isPawn(oldPos.y, oldPos.x))
-		eSquarePos = sf::Vector2u(oldPos.x, 5);
-
-	if (oldPos.y == 1 && newPos.y == 3 && isPawn(oldPos.y, oldPos.x))
-		eSquarePos = sf::Vector2u(oldPos.x, 2);
-}
-
-// Castling
-
-void Board::castle(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
-{
-	// add functions that gauges whether:
-	// any of the rooks have moved
-	// any of the kings have moved
-	// any of the rooks have been captured
-
-	Squares oldSquare = squareFromPos(oldPos);
-	Squares newSquare = squareFromPos(newPos);
-	sf::Vector2u rookOldPos, rookNewPos;
-
-	if (oldSquare == Squares::e1 && newSquare == Squares::g1)		// white kingside
-	{
-		rookOldPos = getSquarePos(Squares::h1);
-		rookNewPos = getSquarePos(Squares::f1);
-		White.kingsideCastling = false;
-		White.queensideCastling = false;
-	}
-
-	if (oldSquare == Squares::e1 && newSquare == Squares::c1)		// white queenside
-	{
-		rookOldPos = getSquarePos(Squares::a1);
-		rookNewPos = getSquarePos(Squares::d1);
-		White.kingsideCastling = false;
-		White.queensideCastling = false;
-	}
-
-	if (oldSquare == Squares::e8 && newSquare == Squares::g8)		// black kingside
-	{
-		rookOldPos = getSquarePos(Squares::h8);
-		rookNewPos = getSquarePos(Squares::f8);
-		Black.kingsideCastling = false;
-		Black.queensideCastling = false;
-	}
-
-	if (oldSquare == Squares::e8 && newSquare == Squares::c8)		// black queenside
-	{
-		rookOldPos = getSquarePos(Squares::a8);
-		rookNewPos = getSquarePos(Squares::d8);
-		Black.kingsideCastling = false;
-		Black.queensideCastling = false;
-	}
-
-	board[newPos.y][newPos.x] = board[oldPos.y][oldPos.x];
-	board[oldPos.y][oldPos.x] = 0;
-	board[rookNewPos.y][rookNewPos.x] = board[rookOldPos.y][rookOldPos.x];
-	board[rookOldPos.y][rookOldPos.x] = 0;
-}
-
-bool Board::isKing(const int& i, const int& j)
-{
-	return abs(board[i][j]) == 1;
-}
+// Move Handling
 
-void Board::setCastlingSquares()
+IntPairVec Board::getPieceMoves(const int& i, const int& j)
 {
-	castlingSquares.clear();
-	sf::Vector2u castlingSquare;
-
-	if (whiteToMove)
-	{
-		if (castlingPossible(White, true))					// white kingside castling
-		{
-			castlingSquare = getSquarePos(Squares::g1);
-			castlingSquares.push_back(IntPair(castlingSquare.x, castlingSquare.y));
-		}
-
-		if (castlingPossible(White, false))					// white queenside castling
-		{
-			castlingSquare = getSquarePos(Squares::c1);
-			castlingSquares.push_back(IntPair(castlingSquare.x, castlingSquare.y));
-		}
-	}
-
-	if (!whiteToMove)
-	{
-		if (castlingPossible(Black, true))					// black kingside castling
-		{
-			castlingSquare = getSquarePos(Squares::g8);
-			castlingSquares.push_back(IntPair(castlingSquare.x, castlingSquare.y));
-		}
-
-		if (castlingPossible(Black, false))					// black queenside castling
-		{
-			castlingSquare = getSquarePos(Squares::c8);
-			castlingSquares.push_back(IntPair(castlingSquare.x, castlingSquare.y));
-		}
-	}
+	return toPosVec(game.getLegalMoves(toSquare(i, j)));		// legal destinations, including castling and en passant
 }
 
-bool Board::castlingPossible(const Player& player, const bool& kingside)
+void Board::saveMove(const Position& before, const Move& move)
 {
-	if (kingside)								// kingside castling
-	{
-		if (!player.kingsideCastling)			// if kingside castling rights are not available
-			return false;
-
-		Squares fSquare, gSquare;
-
-		if (whiteToMove)	fSquare = Squares::f1, gSquare = Squares::g1;
-		else				fSquare = Squares::f8, gSquare = Squares::g8;
-
-		if (!player.inCheck && !player.kingMoved && !player.hRookMoved && !player.hRookCaptured &&
-			!getValueAt(fSquare) && !getValueAt(gSquare) && !isThreatened(fSquare) && !isThreatened(gSquare))
-			return true;
-
-		return false;
-	}
-	else										// queenside castling
-	{
-		if (!player.queensideCastling)			// if queenside castling rights are not available
-			return false;
+	// numbered SAN as in a PGN file, e.g. 12. Nf3 or 12... Nf6, whichever way the board is flipped
 
-		Squares bSquare, cSquare, dSquare;
-
-		if (whiteToMove)	bSquare = Squares::b1, cSquare = Squares::c1, dSquare = Squares::d1;
-		else				bSquare = Squares::b8, cSquare = Squares::c8, dSquare = Squares::d8;
-
-		if (!player.inCheck && !player.kingMoved && !player.aRookMoved && !player.aRookCaptured &&
-			!getValueAt(bSquare) && !getValueAt(cSquare) && !getValueAt(dSquare) &&
-			!isThreatened(bSquare) && !isThreatened(cSquare) && !isThreatened(dSquare))
-			return true;
-
-		return false;
-	}
+	std::cout << "\n" << before.fullMoveNumber() << (before.sideToMove() == white ? ". " : "... ") << moveToSan(before, move) << "\n";
 }
 
-void Board::updateCastlingStatus(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
+void Board::playMove(const Move& move)
 {
-	Squares oldSquare = squareFromPos(oldPos);
-	Squares newSquare = squareFromPos(newPos);
-
-	// piece moved
-
-	switch (oldSquare)
-	{
-	case Squares::e1:						// white king moved
-		White.kingsideCastling = false;
-		White.queensideCastling = false;
-		break;
-	case Squares::a1:						// white 'a' rook moved
-		White.queensideCastling = false;
-		break;
-	case Squares::h1:						// white 'h' rook moved
-		White.kingsideCastling = false;
-		break;
-	case Squares::e8:						// black king moved
-		Black.kingsideCastling = false;
-		Black.queensideCastling = false;
-		break;
-	case Squares::a8:						// black 'a' rook moved
-		Black.queensideCastling = false;
-		break;
-	case Squares::h8:						// black 'h' rook moved
-		Black.kingsideCastling = false;
-		break;
-	default:
-		break;
-	}
-
-	// piece captured
+	Position before = game.getPosition();										// SAN is read off the position the move is played from
 
-	switch (newSquare)
-	{
-	case Squares::a1:						// white 'a' rook captured
-		White.queensideCastling = false;
-		break;
-	case Squares::h1:						// white 'h' rook captured
-		White.kingsideCastling = false;
-		break;
-	case Squares::a8:						// black 'a' rook captured
-		Black.queensideCastling = false;
-		break;
-	case Squares::h8:						// black 'h' rook captured
-		Black.queensideCastling = false;
-		break;
-	default:
-		break;
-	}
-}
-
-// Move Handling
-
-void Board::makeMove(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
-{
-	board[newPos.y][newPos.x] = board[oldPos.y][oldPos.x];			// capture piece
-	board[oldPos.y][oldPos.x] = 0;									// remove piece from old position
-}
+	if (!game.playMove(move))
+		return;
 
-void Board::saveMove(const sf::Vector2u& oldPos, const sf::Vector2u& newPos)
-{
-	std::string move{ getFile(oldPos.x), getRank(oldPos.y), getFile(newPos.x), getRank(newPos.y) };
+	saveMove(before, game.getPlayedMoves().back());								// print the move that was played, flags set by the game
 
-	playedMoves.push_back(move);
-	std::cout << "\n" << move << "\n";
+	IntPair to = toPos(move.to());
+	hSquarePos = sf::Vector2u(to.first, to.second);								// hSquare set to destination square
+	moveAllowed = true;															// set to true to highlight new square
+	getAllThreats();															// find all threats for other player
+	checkGameEnd();																// check for checkmate or stalemate
+	startEngine();																// reply if the computer is to move
+	batchesDirty = true;
 }
 
 void Board::undoMove()
 {
-	// Warning: This function does not work for en passant, castling etc.
-	// Many attributes are not reset, only board position is reset.
-
-	if (!playedMoves.empty())
-	{
-		playedMoves.pop_back();
-
-		loadPosition();
-	}
-}
-
-void Board::loadPosition()
-{
-	FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
-	loadFen();
-
-	int index = 0;
+	if (!game.canUndo())
+		return;
 
-	while (playedMoves.begin() + index < playedMoves.end())
-	{
-		std::string move = *(playedMoves.begin() + index);
+	bool gameOver = game.getResult() != gameResults::ongoing;
 
-		std::string oldStr = move.substr(0, 2);
-		std::string newStr = move.substr(2, 2);
+	cancelEngine();
+	game.undoMove();
 
-		makeMove(getSquarePos(squareFromStr(oldStr)), getSquarePos(squareFromStr(newStr)));
-		whiteToMove = !whiteToMove;
+	if (engineEnabled && game.getPosition().sideToMove() == engineColor)		// take back the computer's reply as well
+		game.undoMove();
 
-		++index;
-	}
+	if (gameOver)
+		selectBoardTheme(boardTheme);			// restore the colors darkened by checkGameEnd()
 
 	moveAllowed = false;
+	movesVisible = false;
+	availableMoves.clear();
 	getAllThreats();
+	startEngine();								// the computer moves first if the undo went back to its turn
+	batchesDirty = true;
 }
 
-
-// Threats Calculation
-
-IntPairVec Board::findThreats(const int& i, const int& j, const IntPairVec& delta, const bool& longRange)
+void Board::saveGame()
 {
-	IntPairVec threats;
-
-	for (auto it = delta.begin(); it != delta.end(); ++it)									// loop over all the directions that piece can move in
-	{
-		int dx = it->first;																	// change in direction in x axis
-		int dy = it->second;																// change in direction in y axis (flipped in SFML)
-
-		do
-		{
-			if (!isOnBoard(j + dx, i + dy))													// if out of board
-				break;
-
-			threats.push_back({ j + dx, i + dy });											// store move as (x, y) coordinates
-
-			if (board[i + dy][j + dx])														// if square is occupied by piece
-				break;
-
-			dx = dx ? dx + dx / abs(dx) : 0;												// signed increment with divide by zero check
-			dy = dy ? dy + dy / abs(dy) : 0;
+	std::ofstream out(gameFile);
+	writePgn(out, makePgnGame(game));
 
-		} while (longRange);																// continue searching along a line or diagonal
-	}
-
-	return threats;
+	if (out)
+		std::cout << "\nGame saved to " << gameFile << std::endl;
+	else
+		std::cerr << "Error! " << gameFile << " not written! Board::saveGame()" << std::endl;
 }
 
-IntPairVec Board::getPawnThreats(const int& i, const int& j)
+void Board::openGame()
 {
-	IntPairVec delta;
+	PgnReader reader;
+	PgnGame pgn;
 
-	if (pawnMovingUp(i, j))																// pawns moving upwards
+	if (!reader.open(gameFile) || !reader.readGame(pgn))
 	{
-		delta.push_back({ -1, -1 });													// capturing on left diagonal going up
-		delta.push_back({ 1, -1 });														// capturing on right diagonal going up
+		std::cerr << "Error! No game found in " << gameFile << "! Board::openGame()" << std::endl;
+		return;
 	}
 
-	if (pawnMovingDown(i, j))															// pawns moving downwards
-	{
-		delta.push_back({ -1, 1 });														// capturing on left diagonal coming down
-		delta.push_back({ 1, 1 });														// capturing on right diagonal coming down
-	}
+	bool gameOver = game.getResult() != gameResults::ongoing;
 
-	return findThreats(i, j, delta, false);										// find the squares threatened by piece
-}
+	cancelEngine();
+	engineEnabled = false;
 
-IntPairVec Board::getKnightThreats(const int& i, const int& j)
-{
-	IntPairVec delta = { {1, -2}, {2, -1}, {2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2} };
-	return findThreats(i, j, delta, false);
-}
-
-IntPairVec Board::getBishopThreats(const int& i, const int& j)
-{
-	IntPairVec delta = { {1, -1}, {1, 1}, {-1, 1}, {-1, -1} };
-	return findThreats(i, j, delta, true);
-}
-
-IntPairVec Board::getRookThreats(const int& i, const int& j)
-{
-	IntPairVec delta = { {0, -1}, {1, 0}, {0, 1}, {-1, 0} };
-	return findThreats(i, j, delta, true);
-}
+	FenError fenError = game.loadFen(pgn.startFen);
 
-IntPairVec Board::getQueenThreats(const int& i, const int& j)
-{
-	IntPairVec delta = { {0, -1}, {1, 0}, {0, 1}, {-1, 0}, {1, -1}, {1, 1}, {-1, 1}, {-1, -1} };
-	return findThreats(i, j, delta, true);
-}
-
-IntPairVec Board::getKingThreats(const int& i, const int& j)
-{
-	IntPairVec delta = { {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1} };
-	return findThreats(i, j, delta, false);
-}
-
-IntPairVec Board::getPieceThreats(const int& i, const int& j)
-{
-	IntPairVec threats;
-
-	switch (board[i][j])
+	if (fenError != fenOk)						// the current game stays
 	{
-	case 0:														break;		// empty square
-	case 1:	case -1:	threats = getKingThreats(i, j);			break;		// King
-	case 2:	case -2:	threats = getQueenThreats(i, j);		break;		// Queen
-	case 3:	case -3:	threats = getRookThreats(i, j);			break;		// Rook
-	case 4:	case -4:	threats = getBishopThreats(i, j);		break;		// Bishop
-	case 5:	case -5:	threats = getKnightThreats(i, j);		break;		// Knight
-	case 6:	case -6:	threats = getPawnThreats(i, j);			break;		// Pawn
-	default:
-		std::cerr << "Fatal Error! Undefined piece type! Board::getPieceThreats()" << std::endl;
-		std::exit(EXIT_FAILURE);
-	}
-
-	for (auto it = threats.begin(); it != threats.end(); ++it)
-	{
-		if (!existsInVec(*it, allThreats))									// if current threat does not exist in allThreats (prevent duplication)
-			allThreats.push_back(*it);										// add to threats
+		std::cerr << "Error! " << fenErrorText(fenError) << " in the FEN of " << gameFile << "! Board::openGame()" << std::endl;
+		return;
 	}
 
-	return threats;
-}
-
+	if (!pgn.error.empty())
+		std::cerr << "Error! " << pgn.error << " in " << gameFile << ", the game is loaded up to it. Board::openGame()" << std::endl;
 
-// Moves Calculation
-
-IntPairVec Board::getPawnPushes(const int& i, const int& j)
-{
-	IntPairVec pushes;
-
-	// only consider push if the destination square is empty
-	if (pawnMovingUp(i, j))																	// pawns moving upwards
+	for (size_t i = 0; i < pgn.moves.size(); ++i)
 	{
-		if (!board[i - 1][j])																// if empty square in front of pawn
+		if (!game.playMove(pgn.moves[i]))		// the game went on past a fivefold repetition or the 75 move rule
 		{
-			pushes.push_back({ j, i - 1 });													// push one square
-
-			if (i == 6 && !board[i - 2][j])													// if first move and empty square in front, push two squares
-				pushes.push_back({ j, i - 2 });
-		}
-	}
-
-	if (pawnMovingDown(i, j))																// pawns moving downwards
-	{
-		if (!board[i + 1][j])																// if empty square in front of pawn
-		{
-			pushes.push_back({ j, i + 1 });													// push one square
-
-			if (i == 1 && !board[i + 2][j])													// if first move and empty square in front, push two squares
-				pushes.push_back({ j, i + 2 });
+			std::cerr << "Error! The game in " << gameFile << " ended at ply " << i << ", the last " << pgn.moves.size() - i
+				<< " moves are not loaded. Board::openGame()" << std::endl;
+			break;
 		}
 	}
 
-	return pushes;
-}
-
-IntPairVec Board::getPawnMoves(const int& i, const int& j)
-{
-	IntPairVec threats = getPawnThreats(i, j);
-	IntPairVec wrongThreats, moves;
-
-	// threats are considered moves only if opponent piece on pawn diagonal or enPassantSquare
-	for (size_t k = 0; k < threats.size(); ++k)
-	{
-		if (!isPieceCapture(i, j, threats[k].second, threats[k].first))
-			wrongThreats.push_back(threats[k]);
-	}
-
-	for (IntPair& t : threats)
-	{
-		if (!existsInVec(t, wrongThreats))
-			moves.push_back(t);
-	}
-
-	IntPairVec pushes = getPawnPushes(i, j);
+	if (gameOver)
+		selectBoardTheme(boardTheme);			// restore the colors darkened by checkGameEnd()
 
-	moves.insert(moves.end(), pushes.begin(), pushes.end());
-	return moves;
+	moveAllowed = false;
+	movesVisible = false;
+	availableMoves.clear();
+	getAllThreats();
+	checkGameEnd();
+	batchesDirty = true;
 }
 
-IntPairVec Board::getPieceMoves(const int& i, const int& j)
+void Board::redoMove()
 {
-	IntPairVec moves, wrongMoves, correctMoves;		// moves stores candidate moves, wrongMoves stores illegal moves
-
-	if (isPawn(i, j))
-		moves = getPawnMoves(i, j);					// pawns move and capture differently
-	else
-		moves = getPieceThreats(i, j);				// other pieces move and capture in same manner
-
-	// add illegal moves to wrongMoves
-	for (size_t k = 0; k < moves.size(); ++k)
-	{
-		if (!isLegalMove(i, j, moves[k].second, moves[k].first))
-			wrongMoves.push_back(moves[k]);
-	}
-
-	// add those moves to availableMoves which do not exist in wrongMoves
-	for (IntPair& m : moves)
-	{
-		if (!existsInVec(m, wrongMoves))
-			correctMoves.push_back(m);
-	}
-
-	// populate list of squares for pawn promotion
-	promotionSquares.clear();
+	if (!game.canRedo())
+		return;
 
-	if (isPawn(i, j))
-	{
-		for (IntPair& move : correctMoves)
-			setPromotionSquare(sf::Vector2u(j, i), sf::Vector2u(move.first, move.second));
-	}
+	cancelEngine();
+	game.redoMove();
 
-	// populate list of squares for castling
+	if (enginesTurn() && game.canRedo())		// replay the computer's reply as well
+		game.redoMove();
 
-	if (isKing(i, j))
-	{
-		setCastlingSquares();
-		correctMoves.insert(correctMoves.end(), castlingSquares.begin(), castlingSquares.end());
-	}
-
-	return correctMoves;
+	moveAllowed = false;
+	movesVisible = false;
+	availableMoves.clear();
+	getAllThreats();
+	checkGameEnd();
+	startEngine();
+	batchesDirty = true;
 }
 
 
-// Move Validation
+// Engine
 
-bool Board::isOnBoard(const int& x, const int& y)
+bool Board::enginesTurn()
 {
-	if (x < 0 || x > 7 || y < 0 || y > 7)	return false;
-	else									return true;
+	return engineEnabled && game.getPosition().sideToMove() == engineColor;
 }
 
-bool Board::isPieceCapture(const int& i, const int& j, const int& new_i, const int& new_j)
+void Board::startEngine()
 {
-	if (isPawn(i, j) && eSquarePos == sf::Vector2u(new_j, new_i))		// en passant capture for pawns
-		return true;
-
-	if (board[i][j] > 0 && board[new_i][new_j] < 0)				// white can capture black piece
-		return true;
+	if (!enginesTurn() || engineThinking || game.getResult() != gameResults::ongoing)
+		return;
 
-	if (board[i][j] < 0 && board[new_i][new_j] > 0)				// black and capture white piece
-		return true;
+	SearchLimits limits;
+	limits.moveTime = engineMoveTime;
 
-	return false;
+	if (engine.post(++engineJob, game.getPosition(), limits, game.getKeyHistory()))
+		engineThinking = true;
 }
 
-bool Board::putsInCheck(const int& i, const int& j, const int& new_i, const int& new_j)
+void Board::cancelEngine()
 {
-	// store board position
-
-	int tempBoard[8][8] = { 0 };
-
-	for (int r = 0; r < 8; ++r)
-		for (int s = 0; s < 8; ++s)
-			tempBoard[r][s] = board[r][s];
-
-	// "make" the  move
-
-	if (isPawn(i, j) && eSquarePos == sf::Vector2u(new_j, new_i))
-		enPassant(sf::Vector2u(j, i), sf::Vector2u(new_j, new_i));
-	else
-		makeMove(sf::Vector2u(j, i), sf::Vector2u(new_j, new_i));
-
-	// find new threats and see if king ends up in check
-
-	getAllThreats();
-
-	bool putInCheck = whiteToMove && White.inCheck || !whiteToMove && Black.inCheck;
-
-	// restore the position of the board
-
-	for (int r = 0; r < 8; ++r)
-		for (int s = 0; s < 8; ++s)
-			board[r][s] = tempBoard[r][s];
-
-	// get original threats and player inCheck flags
-
-	getAllThreats();
+	if (!engineThinking)
+		return;
 
-	if (putInCheck)		return true;
-	else				return false;
+	engine.cancel();
+	++engineJob;								// its final report is ignored when it arrives
+	engineThinking = false;
 }
 
-bool Board::isLegalMove(const int& i, const int& j, const int& new_i, const int& new_j)
+void Board::pollEngine()
 {
-	// this function will be applied to check candidate moves calculated by findThreats function
-	// assuming move to be checked is within board bounds
+	EngineReport report;
 
-	if (!board[new_i][new_j] || isPieceCapture(i, j, new_i, new_j))				// destination square is empty OR opponent piece captured
+	while (engine.poll(report))					// reports of cancelled jobs are skipped
 	{
-		if (isKing(new_i, new_j))										// king capture is not allowed
-			return false;
+		if (report.job != engineJob || !report.finished)
+			continue;
 
-		if (putsInCheck(i, j, new_i, new_j))									// if move puts king in check (OR does not move king out of check)
-			return false;
-
-		return true;															// passes all tests
-	}
+		engineThinking = false;
 
-	return false;			// destination piece is player's piece
-}
-
-
-// Checks
-
-void Board::isCheck()
-{
-	// find position of white and black kings
-
-	for (int i = 0; i < 8; ++i)
-	{
-		for (int j = 0; j < 8; ++j)
+		if (!report.info.pv.empty())
 		{
-			if (board[i][j] == 1)		White.kingPos = { j, i };
-			if (board[i][j] == -1)		Black.kingPos = { j, i };
+			std::cout << "\nEngine: depth " << report.info.depth << ", score " << report.info.score << ", " << report.info.nps << " nodes/s";
+			playMove(report.info.pv[0]);
 		}
 	}
+}
 
-	White.inCheck = false;
-	Black.inCheck = false;
 
-	for (auto it = allThreats.begin(); it != allThreats.end(); ++it)
-	{
-		if (whiteToMove && White.kingPos == *it)
-			White.inCheck = true;
-
-		if (!whiteToMove && Black.kingPos == *it)
-			Black.inCheck = true;
-	}
-}
+// Checks
 
 void Board::getAllThreats()
 {
-	allThreats.clear();
-
-	for (int i = 0; i < 8; ++i)
-		for (int j = 0; j < 8; ++j)
-			if (whiteToMove && board[i][j] < 0 || !whiteToMove && board[i][j] > 0)
-				getPieceThreats(i, j);
-
-	isCheck();
+	const Position& position = game.getPosition();
+	allThreats = toPosVec(position.attacksBy(Color(!position.sideToMove())));	// squares threatened by the enemy
 }
 
 void Board::checkGameEnd()
 {
-	IntPairVec moves, allMoves;
-
-	for (int i = 0; i < 8; i++)
-	{
-		for (int j = 0; j < 8; j++)
-		{
-			if (whiteToMove && board[i][j] > 0 || !whiteToMove && board[i][j] < 0)
-			{
-				moves = getPieceMoves(i, j);
-				allMoves.insert(allMoves.end(), moves.begin(), moves.end());
-
-				if (!allMoves.empty())	return;				// if any possible moves, return to save time
-			}
-		}
-	}
-
-	if (allMoves.empty() && White.inCheck || Black.inCheck)
+	switch (game.getResult())
 	{
-		checkmate = true;
-		std::cout << "\nCheckmate! " << (whiteToMove ? "Black" : "White") << " wins the game." << std::endl;
+	case gameResults::checkmate:
+		std::cout << "\nCheckmate! " << (game.getPosition().sideToMove() == white ? "Black" : "White") << " wins the game." << std::endl;
 		bColor = sf::Color(25, 25, 25, 255);
-	}
-
-	if (allMoves.empty() && !White.inCheck && !Black.inCheck)
-	{
-		stalemate = true;
+		break;
+	case gameResults::stalemate:
 		std::cout << "\nStalemate! Game ends in a draw." << std::endl;
 		bColor = sf::Color(25, 25, 25, 255);
+		break;
+	case gameResults::seventyFiveMoveRule:
+		std::cout << "\nSeventy-five moves without a capture or pawn move! Game ends in a draw." << std::endl;
+		bColor = sf::Color(25, 25, 25, 255);
+		break;
+	case gameResults::fivefoldRepetition:
+		std::cout << "\nFivefold repetition! Game ends in a draw." << std::endl;
+		bColor = sf::Color(25, 25, 25, 255);
+		break;
+	case gameResults::insufficientMaterial:
+		std::cout << "\nInsufficient material! Game ends in a draw." << std::endl;
+		bColor = sf::Color(25, 25, 25, 255);
+		break;
+
+	default:
+		if (game.canClaimDraw())
+			std::cout << "\nThreefold repetition or fifty moves without a capture or pawn move, a draw can be claimed." << std::endl;
+		break;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,165 @@
+#include "Engine.h"
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+Engine::Engine(int threads, size_t hashMB) : tt(hashMB)
+{
+	searching = false;
+	setThreads(threads);
+}
+
+Engine::~Engine()
+{
+	stop();
+	wait();
+}
+
+
+// Options
+
+void Engine::setThreads(int threads)
+{
+	stop();
+	wait();
+
+	threads = threads < 1 ? 1 : threads;
+	searches.clear();
+
+	for (int i = 0; i < threads; ++i)
+		searches.emplace_back(new Search(tt, shared, i));
+
+	shared.threadCount = threads;
+
+	searches[0]->onIteration([this](const SearchInfo& info)			// report all threads together
+	{
+		if (!iterationCallback)
+			return;
+
+		SearchInfo total = info;
+		total.nodes = totalNodes();
+		total.nps = total.nodes * 1000 / (total.time > 0 ? total.time : 1);
+		iterationCallback(total);
+	});
+}
+
+int Engine::getThreads() const
+{
+	return int(searches.size());
+}
+
+void Engine::setHashSize(size_t megabytes)
+{
+	stop();
+	wait();
+	tt.resize(megabytes);
+}
+
+void Engine::clearHash()
+{
+	stop();
+	wait();
+	tt.clear();
+}
+
+int Engine::hashfull() const
+{
+	return tt.hashfull();
+}
+
+
+// Searching
+
+void Engine::start(const Position& pos, const SearchLimits& limits, const std::vector<Key>& history)
+{
+	stop();
+	wait();
+
+	shared.stop = false;
+
+	for (int depth = 0; depth < maxPly; ++depth)
+		shared.threadsAtDepth[depth] = 0;
+
+	tt.newSearch();
+	searching = true;
+	searchThread = std::thread(&Engine::run, this, pos, limits, history);
+}
+
+void Engine::stop()
+{
+	shared.stop = true;
+}
+
+void Engine::wait()
+{
+	if (searchThread.joinable())
+		searchThread.join();
+}
+
+bool Engine::isSearching() const
+{
+	return searching;
+}
+
+SearchInfo Engine::getResult() const
+{
+	return result;
+}
+
+void Engine::onIteration(const std::function<void(const SearchInfo&)>& callback)
+{
+	iterationCallback = callback;
+}
+
+void Engine::onFinish(const std::function<void(const SearchInfo&)>& callback)
+{
+	finishCallback = callback;
+}
+
+
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
+
+void Engine::run(const Position& pos, const SearchLimits& limits, const std::vector<Key>& history)
+{
+	// helpers search until the main thread is done, the main thread alone keeps to the time limit
+
+	SearchLimits helperLimits = limits;
+	helperLimits.moveTime = 0;
+
+	std::vector<SearchInfo> helperResults(searches.size());
+	std::vector<std::thread> helpers;
+
+	for (size_t i = 1; i < searches.size(); ++i)
+		helpers.emplace_back([this, i, &pos, &helperLimits, &history, &helperResults]() { helperResults[i] = searches[i]->think(pos, helperLimits, history); });
+
+	SearchInfo best = searches[0]->think(pos, limits, history);
+
+	shared.stop = true;
+
+	for (std::thread& helper : helpers)
+		helper.join();
+
+	for (size_t i = 1; i < searches.size(); ++i)						// a helper that completed a deeper iteration knows better
+		if (helperResults[i].depth > best.depth && !helperResults[i].pv.empty())
+			best = helperResults[i];
+
+	best.nodes = totalNodes();
+	best.nps = best.nodes * 1000 / (best.time > 0 ? best.time : 1);
+	result = best;
+
+	if (finishCallback)
+		finishCallback(result);
+
+	searching = false;
+}
+
+uint64_t Engine::totalNodes() const
+{
+	uint64_t nodes = 0;
+
+	for (const std::unique_ptr<Search>& search : searches)
+		nodes += search->getNodes();
+
+	return nodes;
+}
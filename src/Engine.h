@@ -0,0 +1,54 @@
+#pragma once
+#include "Search.h"
+#include <memory>
+#include <thread>
+
+// Runs searches in the background on any number of threads sharing one transposition table (Lazy
+// SMP). start() returns at once, so a caller such as the SFML event loop is never blocked; the
+// result is collected with wait() or getResult() once isSearching() turns false.
+
+class Engine
+{
+	// Public Functions
+public:
+	// Constructor
+
+	Engine(int threads = 1, size_t hashMB = 16);
+	~Engine();
+
+	// Options, applied between searches
+
+	void setThreads(int threads);
+	int getThreads() const;
+	void setHashSize(size_t megabytes);
+	void clearHash();
+	int hashfull() const;												// permille of the table used by the current search
+
+	// Searching
+
+	void start(const Position& pos, const SearchLimits& limits, const std::vector<Key>& history = std::vector<Key>());	// stops a running search first
+	void stop();
+	void wait();														// blocks until the running search has finished
+	bool isSearching() const;
+	SearchInfo getResult() const;										// result of the last finished search
+
+	void onIteration(const std::function<void(const SearchInfo&)>& callback);	// called on the search thread after every depth
+	void onFinish(const std::function<void(const SearchInfo&)>& callback);		// called on the search thread with the result
+
+	// Private Functions
+private:
+	void run(const Position& pos, const SearchLimits& limits, const std::vector<Key>& history);	// arguments are the copies std::thread keeps
+	uint64_t totalNodes() const;
+
+	// Private Variables
+private:
+	TranspositionTable tt;									// shared by all threads
+	SearchShared shared;									// stop flag and depth counts of the running search
+	std::vector<std::unique_ptr<Search>> searches;			// one per thread, searches[0] runs on the main search thread
+	std::thread searchThread;								// runs searches[0] and starts the helpers
+	std::atomic<bool> searching;							// true from start() until the result is stored
+	SearchInfo result;										// written by the search thread before searching turns false
+
+	std::function<void(const SearchInfo&)> iterationCallback;
+	std::function<void(const SearchInfo&)> finishCallback;
+};
@@ -0,0 +1,122 @@
+#include "EngineWorker.h"
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+EngineWorker::EngineWorker(int threads, size_t hashMB) : engine(threads, hashMB)
+{
+	currentJob = 0;
+	quitting = false;
+
+	// reports are pushed from the search thread, one search at a time, so the queue keeps a single producer
+
+	engine.onIteration([this](const SearchInfo& info)
+	{
+		reports.push({ currentJob, false, info });
+	});
+
+	engine.onFinish([this](const SearchInfo& info)
+	{
+		while (!reports.push({ currentJob, true, info }) && !quitting)	// the final report must not be lost while the UI is there
+			std::this_thread::yield();
+	});
+
+	worker = std::thread(&EngineWorker::loop, this);
+}
+
+EngineWorker::~EngineWorker()
+{
+	quitting = true;
+
+	Command quit;
+	quit.type = commandTypes::quit;
+
+	while (!commands.push(quit))
+		std::this_thread::yield();
+
+	wakeWorker();
+	worker.join();
+}
+
+
+// Jobs
+
+bool EngineWorker::post(int job, const Position& pos, const SearchLimits& limits, const std::vector<Key>& history)
+{
+	Command think;
+	think.type = commandTypes::think;
+	think.job = job;
+	think.pos = pos;
+	think.limits = limits;
+	think.history = history;
+
+	if (!commands.push(think))
+		return false;
+
+	wakeWorker();
+	return true;
+}
+
+bool EngineWorker::cancel()
+{
+	Command stop;
+	stop.type = commandTypes::stop;
+
+	if (!commands.push(stop))
+		return false;
+
+	wakeWorker();
+	return true;
+}
+
+bool EngineWorker::poll(EngineReport& report)
+{
+	return reports.pop(report);
+}
+
+
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
+
+void EngineWorker::loop()
+{
+	Command command;
+
+	while (true)
+	{
+		if (!commands.pop(command))
+		{
+			std::unique_lock<std::mutex> lock(wakeMutex);					// idle, nothing to do until the UI posts
+			wake.wait(lock, [this]() { return !commands.empty(); });
+			continue;
+		}
+
+		switch (command.type)
+		{
+		case commandTypes::think:
+			engine.stop();
+			engine.wait();									// the previous job has sent its final report
+			currentJob = command.job;
+			engine.start(command.pos, command.limits, command.history);
+			break;
+		case commandTypes::stop:
+			engine.stop();
+			break;
+		case commandTypes::quit:
+			engine.stop();
+			engine.wait();
+			return;
+		}
+	}
+}
+
+void EngineWorker::wakeWorker()
+{
+	// taking the mutex orders the push before the worker's check, so the signal cannot be missed
+
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+	}
+
+	wake.notify_one();
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "Engine.h"
+#include "SpscQueue.h"
+#include <condition_variable>
+#include <mutex>
+
+// Engine on its own worker thread for interactive front ends. The UI thread posts "think on this
+// position" jobs and picks up progress and final reports with poll(), once per frame; both queues
+// are lock-free, so the UI thread never waits on the engine however long it searches. While there
+// is nothing to do the worker sleeps on a condition variable, which post() and cancel() signal.
+
+struct EngineReport
+{
+	int job;						// id given to post()
+	bool finished;					// false for progress after each depth, true once with the result
+	SearchInfo info;
+};
+
+class EngineWorker
+{
+	// Public Functions
+public:
+	// Constructor
+
+	EngineWorker(int threads = 1, size_t hashMB = 16);
+	~EngineWorker();
+
+	// Jobs
+
+	bool post(int job, const Position& pos, const SearchLimits& limits, const std::vector<Key>& history);	// false if the command queue is full
+	bool cancel();															// stops the running job, which still sends its final report
+	bool poll(EngineReport& report);										// next report if there is one, never blocks
+
+	// Private Types
+private:
+	enum class commandTypes { think, stop, quit };
+
+	struct Command
+	{
+		commandTypes type;
+		int job;
+		Position pos;
+		SearchLimits limits;
+		std::vector<Key> history;				// earlier positions of the game, for repetitions
+	};
+
+	// Private Functions
+private:
+	void loop();
+	void wakeWorker();
+
+	// Private Variables
+private:
+	Engine engine;
+	SpscQueue<Command, 16> commands;			// UI thread to worker thread
+	SpscQueue<EngineReport, 256> reports;		// search thread to UI thread, progress is dropped if the UI falls behind
+	int currentJob;								// job being searched, set by the worker before each search starts
+	std::atomic<bool> quitting;					// set when the UI no longer polls for reports
+	std::mutex wakeMutex;						// only held to check for commands and to signal them
+	std::condition_variable wake;				// the worker waits here while the command queue is empty
+	std::thread worker;
+};
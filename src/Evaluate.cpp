@@ -0,0 +1,12 @@
+#include "Evaluate.h"
+
+int evaluate(const Position& pos)
+{
+	if (pos.hasNnue())
+		return nnueEvaluate(pos.nnueAccumulator(), pos.sideToMove());
+
+	int phase = pos.gamePhase() < maxPhase ? pos.gamePhase() : maxPhase;		// promotions can add material beyond the start
+	int score = (pos.midgameScore() * phase + pos.endgameScore() * (maxPhase - phase)) / maxPhase;
+
+	return pos.sideToMove() == white ? score : -score;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "Position.h"
+
+// Static evaluation in centipawns from the point of view of the side to move: the middlegame and
+// endgame piece-square sums kept by Position, blended by how much material is left, or the network
+// output when one is loaded (see Nnue.h).
+
+const int pieceValues[7] = { 0, 0, 900, 500, 330, 320, 100 };		// indexed by PieceType, the king is never traded
+
+int evaluate(const Position& pos);
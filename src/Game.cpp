@@ -0,0 +1,178 @@
+#include "Game.h"
+#include <algorithm>
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+Game::Game(const std::string& fen)
+{
+	if (loadFen(fen) != fenOk)							// a Game always holds a valid position
+		loadFen(startFen);
+}
+
+
+// Setup
+
+FenError Game::loadFen(std::string_view fen)
+{
+	FenError error = position.loadFen(fen);
+
+	if (error != fenOk)
+		return error;
+
+	initialFen = fen;
+	playedMoves.clear();
+	undoStack.clear();
+	redoMoves.clear();
+	updateResult();
+	return fenOk;
+}
+
+
+// Moves
+
+bool Game::playMove(const Move& move)
+{
+	if (result != gameResults::ongoing)
+		return false;
+
+	MoveList moves = getLegalMoves();
+	const Move* legal = std::find_if(moves.begin(), moves.end(), [&](const Move& m) { return m.sameAs(move); });
+
+	if (legal == moves.end())
+		return false;
+
+	if (!redoMoves.empty() && redoMoves.back() == *legal)						// following the undone line keeps the rest of it
+		redoMoves.pop_back();
+	else
+		redoMoves.clear();
+
+	undoStack.emplace_back();
+	position.makeMove(*legal, undoStack.back());								// the generated move carries the castling and en passant flags
+	playedMoves.push_back(*legal);
+	updateResult();
+
+	return true;
+}
+
+bool Game::undoMove()
+{
+	if (playedMoves.empty())
+		return false;
+
+	position.unmakeMove(playedMoves.back(), undoStack.back());
+	redoMoves.push_back(playedMoves.back());
+	playedMoves.pop_back();
+	undoStack.pop_back();
+	updateResult();
+
+	return true;
+}
+
+bool Game::redoMove()
+{
+	if (redoMoves.empty())
+		return false;
+
+	undoStack.emplace_back();
+	position.makeMove(redoMoves.back(), undoStack.back());
+	playedMoves.push_back(redoMoves.back());
+	redoMoves.pop_back();
+	updateResult();
+
+	return true;
+}
+
+bool Game::canUndo() const
+{
+	return !playedMoves.empty();
+}
+
+bool Game::canRedo() const
+{
+	return !redoMoves.empty();
+}
+
+Bitboard Game::getLegalMoves(const Square& from) const
+{
+	return position.legalMoves(from);
+}
+
+MoveList Game::getLegalMoves() const
+{
+	MoveList moves;
+	generateLegalMoves(position, moves);
+	return moves;
+}
+
+
+// State
+
+const Position& Game::getPosition() const
+{
+	return position;
+}
+
+const std::vector<Move>& Game::getPlayedMoves() const
+{
+	return playedMoves;
+}
+
+const std::string& Game::getStartFen() const
+{
+	return initialFen;
+}
+
+std::vector<Key> Game::getKeyHistory() const
+{
+	size_t reach = std::min(undoStack.size(), size_t(position.halfMoveClock()));
+	std::vector<Key> keys;
+
+	for (size_t i = undoStack.size() - reach; i < undoStack.size(); ++i)
+		keys.push_back(undoStack[i].key);
+
+	return keys;
+}
+
+gameResults Game::getResult() const
+{
+	return result;
+}
+
+bool Game::canClaimDraw() const
+{
+	return result == gameResults::ongoing && (position.halfMoveClock() >= 100 || countRepetitions() >= 2);
+}
+
+
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
+
+void Game::updateResult()
+{
+	if (!position.hasLegalMoves())
+		result = position.inCheck() ? gameResults::checkmate : gameResults::stalemate;
+	else if (position.halfMoveClock() >= 150)									// the 75 move rule and fivefold repetition end the game
+		result = gameResults::seventyFiveMoveRule;								// without a claim, earlier draws by rule must be claimed
+	else if (countRepetitions() >= 4)
+		result = gameResults::fivefoldRepetition;
+	else if (position.hasInsufficientMaterial())
+		result = gameResults::insufficientMaterial;
+	else
+		result = gameResults::ongoing;
+}
+
+int Game::countRepetitions() const
+{
+	// the hash before each move is kept in undoStack, only positions with the same side to move
+	// since the last capture or pawn move can be equal, so at most halfMoveClock() entries are read
+
+	int reach = std::min(int(undoStack.size()), position.halfMoveClock());
+	int count = 0;
+
+	for (int i = 2; i <= reach; i += 2)
+		if (undoStack[undoStack.size() - i].key == position.hash())
+			++count;
+
+	return count;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Movegen.h"
+#include <string>
+#include <vector>
+
+enum class gameResults { ongoing, checkmate, stalemate, seventyFiveMoveRule, fivefoldRepetition, insufficientMaterial };
+
+// A game of chess without any user interface: the current position, the moves that led to it and
+// whether it has ended. Board draws a Game, headless tools can drive one directly. Every move keeps
+// the state it cannot be unmade without, so undo and redo take constant time at any game length.
+
+class Game
+{
+	// Public Functions
+public:
+	// Constructor
+
+	Game(const std::string& fen = startFen);			// starts from startFen if fen is invalid
+
+	// Setup
+
+	FenError loadFen(std::string_view fen);			// the game is untouched unless fenOk is returned
+
+	// Moves
+
+	bool playMove(const Move& move);					// returns false and leaves the game untouched if the move is illegal
+	bool undoMove();									// false if no move was played
+	bool redoMove();									// replays the last undone move, false if there is none
+	bool canUndo() const;
+	bool canRedo() const;
+
+	Bitboard getLegalMoves(const Square& from) const;
+	MoveList getLegalMoves() const;
+
+	// State
+
+	const Position& getPosition() const;
+	const std::vector<Move>& getPlayedMoves() const;
+	const std::string& getStartFen() const;
+	std::vector<Key> getKeyHistory() const;				// earlier positions back to the last capture or pawn move, oldest first
+	gameResults getResult() const;
+	bool canClaimDraw() const;							// threefold repetition or fifty move rule, play goes on until a player claims it
+
+	// Private Functions
+private:
+	void updateResult();
+	int countRepetitions() const;						// earlier occurrences of the current position
+
+	// Private Variables
+private:
+	Position position;						// current position
+	std::string initialFen;					// position the game started from
+	std::vector<Move> playedMoves;			// moves played since initialFen
+	std::vector<UndoInfo> undoStack;		// state before each of playedMoves, same length
+	std::vector<Move> redoMoves;			// undone moves, the next one to redo at the back
+	gameResults result = gameResults::ongoing;	// ongoing until checkmate, stalemate or a draw that needs no claim
+};
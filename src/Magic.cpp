@@ -0,0 +1,126 @@
+#include "Magic.h"
+#include <vector>
+
+Magic bishopMagics[64];
+Magic rookMagics[64];
+
+static Bitboard bishopTable[0x1480];		// 5248 entries, sum of 2^bits over all squares
+static Bitboard rookTable[0x19000];			// 102400 entries
+
+static const int bishopDirections[4] = { northEast, northWest, southEast, southWest };
+static const int rookDirections[4] = { north, east, south, west };
+
+// Table Construction
+
+static Bitboard slidingAttacks(const int* directions, Square s, Bitboard occupied)
+{
+	Bitboard attacks = 0;
+
+	for (int k = 0; k < 4; ++k)
+	{
+		int dir = directions[k];
+		Bitboard ray = rayTable[dir][s];
+		Bitboard blockers = ray & occupied;
+
+		if (blockers)															// cut the ray off behind the first blocker
+			ray ^= rayTable[dir][dir < 4 ? lsb(blockers) : msb(blockers)];
+
+		attacks |= ray;
+	}
+
+	return attacks;
+}
+
+#ifndef USE_PEXT
+static uint64_t randomSparse(uint64_t& seed)
+{
+	uint64_t r[3];
+
+	for (int k = 0; k < 3; ++k)													// xorshift64*
+	{
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		r[k] = seed * 2685821657736338717ULL;
+	}
+
+	return r[0] & r[1] & r[2];													// few set bits make better magic candidates
+}
+
+static void findMagic(Magic& m, Square s, const Bitboard* occupancy, const Bitboard* reference, int size)
+{
+	// fixed seeds per rank keep startup fast and the tables identical between runs
+	static const uint64_t seeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+	static std::vector<int> epoch(4096, 0);
+	static int attempt = 0;
+
+	uint64_t seed = seeds[rankOf(s)];
+
+	// try random multipliers until one maps every subset without a harmful collision
+
+	for (int k = 0; k < size; )
+	{
+		do
+			m.magic = randomSparse(seed);
+		while (popCount((m.mask * m.magic) >> 56) < 6);
+
+		++attempt;
+
+		for (k = 0; k < size; ++k)
+		{
+			unsigned idx = m.index(occupancy[k]);
+
+			if (epoch[idx] < attempt)							// first visit in this attempt
+			{
+				epoch[idx] = attempt;
+				m.attacks[idx] = reference[k];
+			}
+			else if (m.attacks[idx] != reference[k])			// collision with different attacks
+				break;
+		}
+	}
+}
+#endif
+
+static void initSlider(Magic magics[64], Bitboard* table, const int* directions)
+{
+	std::vector<Bitboard> occupancy(4096), reference(4096);
+
+	for (int i = 0; i < 64; ++i)
+	{
+		Square s = Square(i);
+		Magic& m = magics[s];
+
+		Bitboard edges = ((rank1BB | rank8BB) & ~(rank1BB << (8 * rankOf(s)))) | ((fileABB | fileHBB) & ~(fileABB << fileOf(s)));
+		m.mask = slidingAttacks(directions, s, 0) & ~edges;
+		m.magic = 0;
+		m.shift = 64 - popCount(m.mask);
+		m.attacks = i == 0 ? table : magics[i - 1].attacks + (1ULL << (64 - magics[i - 1].shift));
+
+		// enumerate every subset of the mask (Carry-Rippler) with its attacks
+
+		int size = 0;
+		Bitboard b = 0;
+
+		do
+		{
+			occupancy[size] = b;
+			reference[size] = slidingAttacks(directions, s, b);
+#ifdef USE_PEXT
+			m.attacks[_pext_u64(b, m.mask)] = reference[size];
+#endif
+			++size;
+			b = (b - m.mask) & m.mask;
+		} while (b);
+
+#ifndef USE_PEXT
+		findMagic(m, s, occupancy.data(), reference.data(), size);
+#endif
+	}
+}
+
+void initMagics()
+{
+	initSlider(bishopMagics, bishopTable, bishopDirections);
+	initSlider(rookMagics, rookTable, rookDirections);
+}
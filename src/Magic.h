@@ -0,0 +1,50 @@
+#pragma once
+#include "Bitboard.h"
+
+// Sliding piece attacks are looked up in tables indexed by the relevant blockers. The index is
+// found with one multiply and shift (magic bitboards), or with a single PEXT instruction when
+// compiled for BMI2. PEXT is microcoded and slow on AMD Zen 1/2, define NO_PEXT for those CPUs.
+
+#if defined(__BMI2__) && !defined(NO_PEXT)
+#define USE_PEXT
+#include <immintrin.h>
+#endif
+
+struct Magic
+{
+	Bitboard mask;					// relevant blocker squares, board edges excluded
+	Bitboard magic;					// multiplier mapping blockers to a unique index (unused with PEXT)
+	Bitboard* attacks;				// start of this square's slice of the attack table
+	unsigned shift;					// 64 minus number of bits in mask
+
+	unsigned index(Bitboard occupied) const
+	{
+#ifdef USE_PEXT
+		return unsigned(_pext_u64(occupied, mask));
+#else
+		return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+	}
+};
+
+extern Magic bishopMagics[64];
+extern Magic rookMagics[64];
+
+void initMagics();					// called by initBitboards(), needs the ray tables
+
+inline Bitboard bishopAttacks(Square s, Bitboard occupied)
+{
+	const Magic& m = bishopMagics[s];
+	return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard rookAttacks(Square s, Bitboard occupied)
+{
+	const Magic& m = rookMagics[s];
+	return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(Square s, Bitboard occupied)
+{
+	return bishopAttacks(s, occupied) | rookAttacks(s, occupied);
+}
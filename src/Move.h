@@ -0,0 +1,98 @@
+#pragma once
+#include "Zobrist.h"
+#include <string>
+
+// special moves, stored in the top two bits so make/unmake need not work them out from the board
+enum MoveFlag { normalMove = 0, promotionMove = 1 << 14, enPassantMove = 2 << 14, castlingMove = 3 << 14 };
+
+// A move packed into 16 bits: from square (bits 0-5), to square (6-11), promotion piece minus queen
+// (12-13) and MoveFlag (14-15). All zeros is no move, as a1a1 can never be played. Moves passed to
+// Position::makeMove() must come from the move generator, which sets the flags.
+
+struct Move
+{
+	uint16_t data;
+
+	Move()
+	{
+		data = 0;
+	}
+
+	Move(Square from, Square to, PieceType promotion = noPieceType)
+	{
+		data = uint16_t(from | to << 6 | (promotion ? promotionMove | (promotion - queen) << 12 : normalMove));
+	}
+
+	Move(Square from, Square to, MoveFlag flag)		// en passant and castling
+	{
+		data = uint16_t(from | to << 6 | flag);
+	}
+
+	static Move fromData(uint16_t data)				// e.g. a move read back from the transposition table
+	{
+		Move move;
+		move.data = data;
+		return move;
+	}
+
+	Square from() const				{ return Square(data & 63); }
+	Square to() const				{ return Square(data >> 6 & 63); }
+	MoveFlag flag() const			{ return MoveFlag(data & (3 << 14)); }
+	PieceType promotion() const		{ return flag() == promotionMove ? PieceType(queen + (data >> 12 & 3)) : noPieceType; }
+	bool isNone() const				{ return data == 0; }
+
+	bool operator==(const Move& other) const		{ return data == other.data; }
+	bool operator!=(const Move& other) const		{ return data != other.data; }
+
+	bool sameAs(const Move& other) const			// same squares and promotion, ignoring the flag of a hand-made move
+	{
+		return from() == other.from() && to() == other.to() && promotion() == other.promotion();
+	}
+};
+
+const int maxMoves = 256;			// more than the 218 legal moves of the richest known position
+
+// Fixed capacity list filled by the move generator, lives on the stack so generating never allocates.
+
+struct MoveList
+{
+	Move moves[maxMoves];
+	int count;
+
+	MoveList()
+	{
+		count = 0;
+	}
+
+	void push_back(const Move& move)				{ moves[count++] = move; }
+	void clear()									{ count = 0; }
+	size_t size() const								{ return size_t(count); }
+	bool empty() const								{ return count == 0; }
+
+	Move& operator[](size_t i)						{ return moves[i]; }
+	const Move& operator[](size_t i) const			{ return moves[i]; }
+
+	Move* begin()									{ return moves; }
+	Move* end()										{ return moves + count; }
+	const Move* begin() const						{ return moves; }
+	const Move* end() const							{ return moves + count; }
+};
+
+struct UndoInfo
+{
+	int captured;					// piece removed by the move (incl. en passant), 0 if none
+	int castling;					// castling rights before the move
+	Square epSquare;				// en passant target square before the move
+	int halfMoves;					// halfmove clock before the move
+	Key key;						// Zobrist hash before the move
+};
+
+inline std::string moveToCoordinate(const Move& move)		// coordinate notation as used by UCI, e.g. e2e4 or e7e8q
+{
+	std::string str{ char('a' + fileOf(move.from())), char('1' + rankOf(move.from())), char('a' + fileOf(move.to())), char('1' + rankOf(move.to())) };
+
+	if (move.promotion())
+		str += " kqrbnp"[move.promotion()];
+
+	return str;
+}
@@ -0,0 +1,296 @@
+#include "Movegen.h"
+#include <cstdlib>
+
+// Adding Moves
+
+static void addMoves(Square from, Bitboard targets, MoveList& moves)
+{
+	while (targets)
+		moves.push_back(Move(from, popLsb(targets)));
+}
+
+static void addPawnMoves(Square from, Bitboard targets, MoveList& moves)
+{
+	while (targets)
+	{
+		Square to = popLsb(targets);
+
+		if (squareBB(to) & (rank1BB | rank8BB))								// one move per promotion piece
+		{
+			for (int pt = queen; pt <= knight; ++pt)
+				moves.push_back(Move(from, to, PieceType(pt)));
+		}
+		else
+			moves.push_back(Move(from, to));
+	}
+}
+
+
+// Checks and Pins
+
+Bitboard checkersTo(const Position& pos)
+{
+	Color us = pos.sideToMove();
+	Square ksq = pos.kingSquare(us);
+
+	if (ksq == noSquare)
+		return 0;
+
+	return pos.attackersTo(ksq, pos.occupied()) & pos.pieces(Color(!us));
+}
+
+Bitboard pinnedPieces(const Position& pos)
+{
+	Color us = pos.sideToMove();
+	Color them = Color(!us);
+	Square ksq = pos.kingSquare(us);
+
+	if (ksq == noSquare)
+		return 0;
+
+	// enemy sliders that would hit the king on an empty board
+	Bitboard snipers = (rookAttacks(ksq, 0) & (pos.pieces(them, rook) | pos.pieces(them, queen)))
+		| (bishopAttacks(ksq, 0) & (pos.pieces(them, bishop) | pos.pieces(them, queen)));
+
+	Bitboard pinned = 0;
+
+	while (snipers)
+	{
+		Bitboard blockers = between(ksq, popLsb(snipers)) & pos.occupied();
+
+		if (popCount(blockers) == 1)											// a lone blocker of ours is pinned
+			pinned |= blockers & pos.pieces(us);
+	}
+
+	return pinned;
+}
+
+
+// Castling, only when not in check, with the rook at home and the king's path empty and safe
+
+static bool canCastle(const Position& pos, Square ksq, bool kingside)
+{
+	Color us = pos.sideToMove();
+	Color them = Color(!us);
+	Bitboard occupied = pos.occupied();
+	int rookPiece = us == white ? rook : -rook;
+
+	if (ksq != (us == white ? e1 : e8))
+		return false;
+
+	if (kingside)
+		return (pos.castlingRights() & (us == white ? whiteKingside : blackKingside)) && pos.pieceAt(Square(ksq + 3)) == rookPiece &&
+			!(occupied & (squareBB(Square(ksq + 1)) | squareBB(Square(ksq + 2)))) &&
+			!pos.isAttacked(Square(ksq + 1), them) && !pos.isAttacked(Square(ksq + 2), them);
+
+	return (pos.castlingRights() & (us == white ? whiteQueenside : blackQueenside)) && pos.pieceAt(Square(ksq - 4)) == rookPiece &&
+		!(occupied & (squareBB(Square(ksq - 1)) | squareBB(Square(ksq - 2)) | squareBB(Square(ksq - 3)))) &&
+		!pos.isAttacked(Square(ksq - 1), them) && !pos.isAttacked(Square(ksq - 2), them);
+}
+
+
+// Generation
+
+static void generate(const Position& pos, MoveList& moves, bool capturesOnly)
+{
+	moves.clear();
+
+	Color us = pos.sideToMove();
+	Color them = Color(!us);
+	Bitboard ours = pos.pieces(us);
+	Bitboard theirs = pos.pieces(them);
+	Bitboard occupied = pos.occupied();
+	Square ksq = pos.kingSquare(us);
+
+	Bitboard checkers = checkersTo(pos);
+	Bitboard pinned = pinnedPieces(pos);
+	Bitboard allowed = capturesOnly ? theirs : ~ours;								// squares pieces may move to
+
+	// king moves, the king is taken off the board so it cannot hide behind itself along a checking ray
+
+	if (ksq != noSquare)
+	{
+		Bitboard targets = kingAttacks(ksq) & allowed;
+		Bitboard withoutKing = occupied ^ squareBB(ksq);
+
+		while (targets)
+		{
+			Square to = popLsb(targets);
+
+			if (!(pos.attackersTo(to, withoutKing) & theirs))
+				moves.push_back(Move(ksq, to));
+		}
+	}
+
+	if (popCount(checkers) > 1)													// double check, only the king can move
+		return;
+
+	// a single check must be captured or blocked, otherwise any square will do
+
+	Bitboard evasion = checkers ? between(ksq, lsb(checkers)) | checkers : ~0ULL;
+
+	// castling
+
+	if (ksq != noSquare && !checkers && !capturesOnly)
+	{
+		if (canCastle(pos, ksq, true))
+			moves.push_back(Move(ksq, Square(ksq + 2), castlingMove));
+
+		if (canCastle(pos, ksq, false))
+			moves.push_back(Move(ksq, Square(ksq - 2), castlingMove));
+	}
+
+	// knights, bishops, rooks and queens, pinned pieces may only move along the pin
+
+	Bitboard pieces = ours & ~pos.pieces(us, king) & ~pos.pieces(us, pawn);
+
+	while (pieces)
+	{
+		Square from = popLsb(pieces);
+		Bitboard targets;
+
+		switch (abs(pos.pieceAt(from)))
+		{
+		case queen:		targets = queenAttacks(from, occupied);		break;
+		case rook:		targets = rookAttacks(from, occupied);		break;
+		case bishop:	targets = bishopAttacks(from, occupied);	break;
+		default:		targets = knightAttacks(from);				break;
+		}
+
+		targets &= allowed & evasion;
+
+		if (pinned & squareBB(from))
+			targets &= line(ksq, from);
+
+		addMoves(from, targets, moves);
+	}
+
+	// pawns
+
+	int forward = us == white ? 8 : -8;
+	int startRank = us == white ? 1 : 6;
+	Bitboard promotionRank = us == white ? rank8BB : rank1BB;
+	Square ep = pos.enPassantSquare();
+	Bitboard pawns = pos.pieces(us, pawn);
+
+	while (pawns)
+	{
+		Square from = popLsb(pawns);
+		Bitboard targets = pawnAttacks(us, from) & theirs;
+		Square one = Square(from + forward);
+
+		if (!(occupied & squareBB(one)) && (!capturesOnly || (squareBB(one) & promotionRank)))	// only promotions count as tactical pushes
+		{
+			targets |= squareBB(one);
+
+			if (rankOf(from) == startRank && !capturesOnly && !(occupied & squareBB(Square(one + forward))))
+				targets |= squareBB(Square(one + forward));
+		}
+
+		targets &= evasion;
+
+		if (pinned & squareBB(from))
+			targets &= line(ksq, from);
+
+		addPawnMoves(from, targets, moves);
+
+		// en passant: remove both pawns and see if anything now hits the king
+
+		if (ep != noSquare && (pawnAttacks(us, from) & squareBB(ep)))
+		{
+			Square captureSquare = makeSquare(fileOf(ep), rankOf(from));
+
+			if (pos.pieceAt(captureSquare) != (us == white ? -pawn : pawn))
+				continue;
+
+			Bitboard after = (occupied ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(ep);
+
+			if (ksq == noSquare || !(pos.attackersTo(ksq, after) & theirs & ~squareBB(captureSquare)))
+				moves.push_back(Move(from, ep, enPassantMove));
+		}
+	}
+}
+
+void generateLegalMoves(const Position& pos, MoveList& moves)
+{
+	generate(pos, moves, false);
+}
+
+void generateLegalCaptures(const Position& pos, MoveList& moves)
+{
+	generate(pos, moves, true);
+}
+
+
+// Single Moves
+
+bool isLegalMove(const Position& pos, const Move& move)
+{
+	Color us = pos.sideToMove();
+	Color them = Color(!us);
+	Square from = move.from();
+	Square to = move.to();
+	Square ksq = pos.kingSquare(us);
+
+	if (move.flag() == castlingMove)
+		return from == ksq && !checkersTo(pos) && canCastle(pos, ksq, to > from);
+
+	if (from == ksq)																// the king may not step onto an attacked square
+		return !(pos.attackersTo(to, pos.occupied() ^ squareBB(from)) & pos.pieces(them));
+
+	if (ksq == noSquare)
+		return true;
+
+	if (move.flag() == enPassantMove)												// remove both pawns and see if anything now hits the king
+	{
+		Square captureSquare = makeSquare(fileOf(to), rankOf(from));
+		Bitboard after = (pos.occupied() ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(to);
+		return !(pos.attackersTo(ksq, after) & pos.pieces(them) & ~squareBB(captureSquare));
+	}
+
+	Bitboard checkers = checkersTo(pos);
+
+	if (popCount(checkers) > 1)
+		return false;
+
+	if (checkers && !((between(ksq, lsb(checkers)) | checkers) & squareBB(to)))	// a single check must be captured or blocked
+		return false;
+
+	return !(pinnedPieces(pos) & squareBB(from)) || (line(ksq, from) & squareBB(to));
+}
+
+bool givesCheck(const Position& pos, const Move& move)
+{
+	// attackers of the enemy king once the move is on the board, pieces of each type moved by hand
+
+	Color us = pos.sideToMove();
+	Square ksq = pos.kingSquare(Color(!us));
+
+	if (ksq == noSquare)
+		return false;
+
+	Square from = move.from();
+	Square to = move.to();
+	PieceType moved = move.promotion() ? move.promotion() : PieceType(abs(pos.pieceAt(from)));
+	Bitboard occupied = (pos.occupied() ^ squareBB(from)) | squareBB(to);
+	Bitboard ours[7];
+
+	for (int pt = king; pt <= pawn; ++pt)
+		ours[pt] = pos.pieces(us, PieceType(pt));
+
+	ours[abs(pos.pieceAt(from))] ^= squareBB(from);
+	ours[moved] |= squareBB(to);
+
+	if (move.flag() == enPassantMove)
+		occupied ^= squareBB(makeSquare(fileOf(to), rankOf(from)));
+
+	if (move.flag() == castlingMove)
+	{
+		Bitboard rookMove = to > from ? squareBB(Square(from + 3)) | squareBB(Square(from + 1)) : squareBB(Square(from - 4)) | squareBB(Square(from - 1));
+		occupied ^= rookMove;
+		ours[rook] ^= rookMove;
+	}
+
+	return (rookAttacks(ksq, occupied) & (ours[rook] | ours[queen])) || (bishopAttacks(ksq, occupied) & (ours[bishop] | ours[queen])) ||
+		(knightAttacks(ksq) & ours[knight]) || (pawnAttacks(Color(!us), ksq) & ours[pawn]);
+}
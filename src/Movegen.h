@@ -0,0 +1,15 @@
+#pragma once
+#include "Position.h"
+
+// Legal move generation. Checkers, pinned pieces and the check evasion mask are computed once per
+// position, so every move emitted is legal without trying it on the board. Only en passant needs an
+// extra occupancy test, as it removes two pieces from the capturing rank at once.
+
+void generateLegalMoves(const Position& pos, MoveList& moves);
+void generateLegalCaptures(const Position& pos, MoveList& moves);	// captures, en passant and promotions only
+
+bool isLegalMove(const Position& pos, const Move& move);	// move must follow the rules of its piece, e.g. from the attack tables
+bool givesCheck(const Position& pos, const Move& move);		// move must be legal
+
+Bitboard checkersTo(const Position& pos);			// enemy pieces giving check to the side to move
+Bitboard pinnedPieces(const Position& pos);			// pieces of the side to move pinned to their king
@@ -0,0 +1,242 @@
+#include "Nnue.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>			// for std::cerr
+#include <memory>
+
+#if !defined(NO_SIMD) && defined(__AVX2__)
+#define NNUE_AVX2
+#include <immintrin.h>
+#elif !defined(NO_SIMD) && defined(__SSE2__)
+#define NNUE_SSE2
+#include <emmintrin.h>
+#elif !defined(NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#define NNUE_NEON
+#include <arm_neon.h>
+#endif
+
+struct Network
+{
+	alignas(64) int16_t featureWeights[nnueFeatures][nnueHidden];
+	alignas(64) int16_t featureBiases[nnueHidden];
+	alignas(64) int16_t outputWeights[2][nnueHidden];	// int8 in the file, widened so every kernel multiplies int16 pairs
+	int32_t outputBias;
+};
+
+static std::unique_ptr<Network> network;
+static int networkId = 0;
+
+// ------------------------------------------- KERNELS -------------------------------------------
+
+static void addRow(int16_t* values, const int16_t* row)
+{
+#if defined(NNUE_AVX2)
+	for (int i = 0; i < nnueHidden; i += 16)
+	{
+		__m256i v = _mm256_load_si256((const __m256i*)(values + i));
+		_mm256_store_si256((__m256i*)(values + i), _mm256_add_epi16(v, _mm256_load_si256((const __m256i*)(row + i))));
+	}
+#elif defined(NNUE_SSE2)
+	for (int i = 0; i < nnueHidden; i += 8)
+	{
+		__m128i v = _mm_load_si128((const __m128i*)(values + i));
+		_mm_store_si128((__m128i*)(values + i), _mm_add_epi16(v, _mm_load_si128((const __m128i*)(row + i))));
+	}
+#elif defined(NNUE_NEON)
+	for (int i = 0; i < nnueHidden; i += 8)
+		vst1q_s16(values + i, vaddq_s16(vld1q_s16(values + i), vld1q_s16(row + i)));
+#else
+	for (int i = 0; i < nnueHidden; ++i)
+		values[i] += row[i];
+#endif
+}
+
+static void subtractRow(int16_t* values, const int16_t* row)
+{
+#if defined(NNUE_AVX2)
+	for (int i = 0; i < nnueHidden; i += 16)
+	{
+		__m256i v = _mm256_load_si256((const __m256i*)(values + i));
+		_mm256_store_si256((__m256i*)(values + i), _mm256_sub_epi16(v, _mm256_load_si256((const __m256i*)(row + i))));
+	}
+#elif defined(NNUE_SSE2)
+	for (int i = 0; i < nnueHidden; i += 8)
+	{
+		__m128i v = _mm_load_si128((const __m128i*)(values + i));
+		_mm_store_si128((__m128i*)(values + i), _mm_sub_epi16(v, _mm_load_si128((const __m128i*)(row + i))));
+	}
+#elif defined(NNUE_NEON)
+	for (int i = 0; i < nnueHidden; i += 8)
+		vst1q_s16(values + i, vsubq_s16(vld1q_s16(values + i), vld1q_s16(row + i)));
+#else
+	for (int i = 0; i < nnueHidden; ++i)
+		values[i] -= row[i];
+#endif
+}
+
+// sum of clip(values, 0, nnueQA) * weights, at most 255 * 127 per product so int32 pairs never overflow
+
+static int32_t clippedDot(const int16_t* values, const int16_t* weights)
+{
+#if defined(NNUE_AVX2)
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ceiling = _mm256_set1_epi16(nnueQA);
+	__m256i sum = _mm256_setzero_si256();
+
+	for (int i = 0; i < nnueHidden; i += 16)
+	{
+		__m256i v = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256((const __m256i*)(values + i)), zero), ceiling);
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, _mm256_load_si256((const __m256i*)(weights + i))));
+	}
+
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+	return _mm_cvtsi128_si32(half);
+#elif defined(NNUE_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ceiling = _mm_set1_epi16(nnueQA);
+	__m128i sum = _mm_setzero_si128();
+
+	for (int i = 0; i < nnueHidden; i += 8)
+	{
+		__m128i v = _mm_min_epi16(_mm_max_epi16(_mm_load_si128((const __m128i*)(values + i)), zero), ceiling);
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(v, _mm_load_si128((const __m128i*)(weights + i))));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+	return _mm_cvtsi128_si32(sum);
+#elif defined(NNUE_NEON)
+	const int16x8_t zero = vdupq_n_s16(0);
+	const int16x8_t ceiling = vdupq_n_s16(nnueQA);
+	int32x4_t sum = vdupq_n_s32(0);
+
+	for (int i = 0; i < nnueHidden; i += 8)
+	{
+		int16x8_t v = vminq_s16(vmaxq_s16(vld1q_s16(values + i), zero), ceiling);
+		int16x8_t w = vld1q_s16(weights + i);
+		sum = vmlal_s16(sum, vget_low_s16(v), vget_low_s16(w));
+		sum = vmlal_high_s16(sum, v, w);
+	}
+
+	return vaddvq_s32(sum);
+#else
+	int32_t sum = 0;
+
+	for (int i = 0; i < nnueHidden; ++i)
+	{
+		int v = values[i] < 0 ? 0 : values[i] > nnueQA ? nnueQA : values[i];
+		sum += v * weights[i];
+	}
+
+	return sum;
+#endif
+}
+
+// row of the feature a piece switches on for the given perspective
+
+static const int16_t* featureRow(int piece, Square s, Color perspective)
+{
+	Color owner = piece > 0 ? white : black;
+	int square = perspective == white ? s : s ^ 56;
+	int index = (owner == perspective ? 0 : 384) + (abs(piece) - 1) * 64 + square;
+
+	return network->featureWeights[index];
+}
+
+// ------------------------------------------- NETWORK -------------------------------------------
+
+bool nnueLoad(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		std::cerr << "Error! Network " << path << " not found! nnueLoad()" << std::endl;
+		return false;
+	}
+
+	char magic[4];
+	int32_t hidden = 0;
+	file.read(magic, 4);
+	file.read((char*)&hidden, sizeof(hidden));
+
+	if (!file || std::memcmp(magic, "NNUE", 4) != 0 || hidden != nnueHidden)
+	{
+		std::cerr << "Error! " << path << " is not a network with " << nnueHidden << " hidden neurons! nnueLoad()" << std::endl;
+		return false;
+	}
+
+	std::unique_ptr<Network> loaded(new Network);
+	int8_t outputWeights[2][nnueHidden];
+
+	file.read((char*)loaded->featureWeights, sizeof(loaded->featureWeights));
+	file.read((char*)loaded->featureBiases, sizeof(loaded->featureBiases));
+	file.read((char*)outputWeights, sizeof(outputWeights));
+	file.read((char*)&loaded->outputBias, sizeof(loaded->outputBias));
+
+	if (!file || file.peek() != std::ifstream::traits_type::eof())
+	{
+		std::cerr << "Error! Network " << path << " has the wrong size! nnueLoad()" << std::endl;
+		return false;
+	}
+
+	for (int side = 0; side < 2; ++side)
+		for (int i = 0; i < nnueHidden; ++i)
+			loaded->outputWeights[side][i] = outputWeights[side][i];
+
+	network = std::move(loaded);
+	++networkId;
+	return true;
+}
+
+void nnueUnload()
+{
+	network.reset();
+	++networkId;
+}
+
+int nnueNetworkId()
+{
+	return network ? networkId : 0;
+}
+
+
+// ------------------------------------------- ACCUMULATOR -------------------------------------------
+
+void nnueReset(Accumulator& acc)
+{
+	acc.network = nnueNetworkId();
+
+	for (int perspective = 0; perspective < 2; ++perspective)
+	{
+		if (network)
+			std::memcpy(acc.values[perspective], network->featureBiases, sizeof(acc.values[perspective]));
+		else
+			std::memset(acc.values[perspective], 0, sizeof(acc.values[perspective]));
+	}
+}
+
+void nnueAdd(Accumulator& acc, int piece, Square s)
+{
+	addRow(acc.values[white], featureRow(piece, s, white));
+	addRow(acc.values[black], featureRow(piece, s, black));
+}
+
+void nnueRemove(Accumulator& acc, int piece, Square s)
+{
+	subtractRow(acc.values[white], featureRow(piece, s, white));
+	subtractRow(acc.values[black], featureRow(piece, s, black));
+}
+
+int nnueEvaluate(const Accumulator& acc, Color sideToMove)
+{
+	int64_t output = int64_t(clippedDot(acc.values[sideToMove], network->outputWeights[0]))
+		+ clippedDot(acc.values[!sideToMove], network->outputWeights[1]) + network->outputBias;
+
+	output = output * nnueScale / (nnueQA * nnueQB);
+
+	return int(output > nnueMaxScore ? nnueMaxScore : output < -nnueMaxScore ? -nnueMaxScore : output);
+}
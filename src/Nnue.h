@@ -0,0 +1,45 @@
+#pragma once
+#include "Bitboard.h"
+#include <cstdint>
+#include <string>
+
+// Optional neural network evaluation. Every piece on the board switches on one of 768 inputs seen
+// from each side (own/enemy, piece type, square flipped for black), feeding a hidden layer of
+// nnueHidden neurons whose sums are kept in an Accumulator. Position adds and subtracts a weight row
+// whenever it puts or removes a piece, so evaluating only has to run the small output layer.
+//
+// Network file, little endian: "NNUE", int32 hidden size, int16 feature weights [768][hidden],
+// int16 feature biases [hidden], int8 output weights [2][hidden] (side to move first), int32 output
+// bias. Feature index is (own ? 0 : 384) + (PieceType - 1) * 64 + square, squares from a1 = 0 and
+// mirrored vertically for black. Hidden values are clipped to [0, nnueQA] and the output is scaled
+// by nnueScale / (nnueQA * nnueQB) to centipawns.
+//
+// Inner loops use AVX2, SSE2 or NEON when the compiler targets them, define NO_SIMD for the plain
+// scalar loops. All paths give identical results.
+
+const int nnueFeatures = 768;
+const int nnueHidden = 256;
+const int nnueQA = 255;							// quantization of the hidden layer
+const int nnueQB = 64;							// quantization of the output weights
+const int nnueScale = 400;						// network output to centipawns
+const int nnueMaxScore = 31935;					// output clamped below the mate scores of the search, which fit an int16_t
+
+struct Accumulator
+{
+	alignas(64) int16_t values[2][nnueHidden];	// hidden layer sums before clipping, indexed by perspective Color
+	int network;								// nnueNetworkId() the sums were built with, 0 if none
+};
+
+// Network
+
+bool nnueLoad(const std::string& path);			// keeps the previous network if the file is missing or malformed
+void nnueUnload();
+int nnueNetworkId();							// 0 without a network, changes with every load
+
+// Accumulator, never load or unload a network while a search is running
+
+void nnueReset(Accumulator& acc);				// empty board with the current network
+void nnueAdd(Accumulator& acc, int piece, Square s);		// piece uses the signed codes of Position::pieceAt()
+void nnueRemove(Accumulator& acc, int piece, Square s);
+
+int nnueEvaluate(const Accumulator& acc, Color sideToMove);	// centipawns from the side to move's point of view, within +-nnueMaxScore
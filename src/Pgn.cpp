@@ -0,0 +1,362 @@
+#include "Pgn.h"
+#include "San.h"
+#include <cctype>
+#include <cstring>
+
+static bool isResult(const char* token)
+{
+	return !std::strcmp(token, "1-0") || !std::strcmp(token, "0-1") || !std::strcmp(token, "1/2-1/2") || !std::strcmp(token, "*");
+}
+
+static const char* resultOf(const Game& game)
+{
+	switch (game.getResult())
+	{
+	case gameResults::ongoing:		return "*";
+	case gameResults::checkmate:	return game.getPosition().sideToMove() == white ? "0-1" : "1-0";
+	default:						return "1/2-1/2";
+	}
+}
+
+// ------------------------------------------- PGN GAME -------------------------------------------
+
+void PgnGame::clear()
+{
+	tags.clear();
+	startFen = ::startFen;
+	moves.clear();
+	result = "*";
+	error.clear();
+}
+
+const std::string* PgnGame::tag(const std::string& name) const
+{
+	for (const PgnTag& t : tags)
+		if (t.name == name)
+			return &t.value;
+
+	return nullptr;
+}
+
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+PgnReader::PgnReader(size_t bufferSize) : buffer(bufferSize)
+{
+	data = buffer.data();
+	position = 0;
+	filled = 0;
+	consumed = 0;
+	tokenLength = 0;
+	token[0] = 0;
+}
+
+
+// Reading
+
+bool PgnReader::open(const std::string& path)
+{
+	file.close();
+	file.clear();
+	file.open(path, std::ios::binary);
+	data = buffer.data();
+	position = 0;
+	filled = 0;
+	consumed = 0;
+	return bool(file);
+}
+
+void PgnReader::open(const char* text, size_t size)
+{
+	file.close();
+	data = text;
+	position = 0;
+	filled = size;
+	consumed = 0;
+}
+
+bool PgnReader::readGame(PgnGame& game)
+{
+	game.clear();
+	bool inMovetext = false;
+
+	while (true)
+	{
+		skipWhitespace();
+		int c = peek();
+
+		if (c < 0)
+			return inMovetext || !game.tags.empty();				// a last game without a result still counts
+
+		if (c == '[')
+		{
+			if (inMovetext)											// the next game starts, this one had no result
+				return true;
+
+			readTag(game);
+		}
+		else if (c == '{')
+			skipUntil('}');
+		else if (c == ';' || c == '%')								// rest of line comment, escaped line
+			skipUntil('\n');
+		else if (c == '(')
+			skipVariation();
+		else
+		{
+			if (!inMovetext)
+			{
+				inMovetext = true;
+
+				FenError fenError = board.loadFen(game.startFen);
+
+				if (fenError != fenOk)								// the moves cannot be replayed, they are skipped
+					game.error = std::string("FEN tag: ") + fenErrorText(fenError);
+			}
+
+			readToken();
+
+			if (isResult(token))
+			{
+				game.result = token;
+				return true;
+			}
+
+			playToken(game);
+		}
+	}
+}
+
+uint64_t PgnReader::bytesRead() const
+{
+	return consumed + position;
+}
+
+
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
+
+// Buffer
+
+int PgnReader::peek()
+{
+	if (position == filled && !refill())
+		return -1;
+
+	return (unsigned char)data[position];
+}
+
+int PgnReader::get()
+{
+	if (position == filled && !refill())
+		return -1;
+
+	return (unsigned char)data[position++];
+}
+
+bool PgnReader::refill()
+{
+	if (!file.is_open() || !file)							// text in memory is read in one go
+		return false;
+
+	consumed += filled;
+	file.read(buffer.data(), std::streamsize(buffer.size()));
+	filled = size_t(file.gcount());
+	position = 0;
+	return filled > 0;
+}
+
+
+// Parsing
+
+void PgnReader::skipWhitespace()
+{
+	while (true)
+	{
+		int c = peek();
+
+		if (c < 0 || !std::isspace(c))
+			return;
+
+		++position;
+	}
+}
+
+void PgnReader::skipUntil(char end)
+{
+	int c;
+
+	while ((c = get()) >= 0 && c != end);
+}
+
+void PgnReader::skipVariation()
+{
+	// variations nest and may contain comments with parentheses of their own
+
+	int depth = 0;
+	int c;
+
+	while ((c = get()) >= 0)
+	{
+		if (c == '{')
+			skipUntil('}');
+		else if (c == '(')
+			++depth;
+		else if (c == ')' && --depth == 0)
+			return;
+	}
+}
+
+void PgnReader::readTag(PgnGame& game)
+{
+	get();														// [
+	PgnTag tag;
+	int c;
+
+	while ((c = get()) >= 0 && c != '"' && c != ']')
+		if (!std::isspace(c))
+			tag.name += char(c);
+
+	if (c == '"')
+	{
+		while ((c = get()) >= 0 && c != '"')
+		{
+			if (c == '\\')										// \" and \\ escapes
+				c = get();
+
+			if (c >= 0)
+				tag.value += char(c);
+		}
+
+		skipUntil(']');
+	}
+
+	if (tag.name == "FEN")
+		game.startFen = tag.value;
+
+	game.tags.push_back(std::move(tag));
+}
+
+void PgnReader::readToken()
+{
+	tokenLength = 0;
+
+	while (true)
+	{
+		int c = peek();
+
+		if (c < 0 || std::isspace(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == '[' || c == ']' || c == ';')
+			break;
+
+		if (tokenLength < sizeof(token) - 1)
+			token[tokenLength++] = char(c);
+
+		++position;
+	}
+
+	if (!tokenLength && peek() >= 0)							// a stray closing bracket, skip it
+		++position;
+
+	token[tokenLength] = 0;
+}
+
+void PgnReader::playToken(PgnGame& game)
+{
+	// move numbers ("12." or "12...") may be glued to the move that follows, NAGs ($1) are skipped
+
+	const char* move = token;
+	const char* dots = token;
+
+	while (std::isdigit((unsigned char)*dots))
+		++dots;
+
+	if (*dots == '.')											// not 0-0, which also starts with a digit
+	{
+		move = dots;
+
+		while (*move == '.')
+			++move;
+	}
+
+	if (!*move || *move == '$' || !game.error.empty())
+		return;
+
+	Move m = sanToMove(board, move);
+
+	if (m.isNone())
+	{
+		game.error = "illegal or ambiguous move " + std::string(move) + " at ply " + std::to_string(game.moves.size() + 1);
+		return;
+	}
+
+	UndoInfo undo;
+	board.makeMove(m, undo);
+	game.moves.push_back(m);
+}
+
+
+// ------------------------------------------- EXPORT -------------------------------------------
+
+PgnGame makePgnGame(const Game& game)
+{
+	PgnGame pgn;
+	pgn.clear();
+	pgn.result = resultOf(game);
+	pgn.tags = { { "Event", "?" }, { "Site", "?" }, { "Date", "????.??.??" }, { "Round", "?" }, { "White", "?" }, { "Black", "?" }, { "Result", pgn.result } };
+
+	if (game.getStartFen() != startFen)
+	{
+		pgn.startFen = game.getStartFen();
+		pgn.tags.push_back({ "SetUp", "1" });
+		pgn.tags.push_back({ "FEN", pgn.startFen });
+	}
+
+	pgn.moves = game.getPlayedMoves();
+	return pgn;
+}
+
+void writePgn(std::ostream& out, const PgnGame& game)
+{
+	for (const PgnTag& tag : game.tags)
+	{
+		out << '[' << tag.name << " \"";
+
+		for (char c : tag.value)
+			out << (c == '"' || c == '\\' ? "\\" : "") << c;
+
+		out << "\"]\n";
+	}
+
+	out << '\n';
+
+	Position pos;
+	pos.loadFen(game.startFen);
+	std::string line;
+
+	auto append = [&](const std::string& word)					// wrap the movetext at 80 columns
+	{
+		if (!line.empty() && line.size() + 1 + word.size() > 80)
+		{
+			out << line << '\n';
+			line.clear();
+		}
+
+		line += (line.empty() ? "" : " ") + word;
+	};
+
+	for (size_t i = 0; i < game.moves.size(); ++i)
+	{
+		if (pos.sideToMove() == white)
+			append(std::to_string(pos.fullMoveNumber()) + ".");
+		else if (i == 0)
+			append(std::to_string(pos.fullMoveNumber()) + "...");
+
+		append(moveToSan(pos, game.moves[i]));
+
+		UndoInfo undo;
+		pos.makeMove(game.moves[i], undo);
+	}
+
+	append(game.result);
+	out << line << "\n\n";
+}
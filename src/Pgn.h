@@ -0,0 +1,75 @@
+#pragma once
+#include "Game.h"
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Portable Game Notation import and export. PgnReader streams a file of any size through one fixed
+// buffer and replays every game through the rules as it is read, so a database of millions of games
+// is validated without ever being held in memory. It can also read text already in memory, e.g. one
+// chunk of a file handed to a worker thread.
+
+struct PgnTag
+{
+	std::string name;
+	std::string value;
+};
+
+struct PgnGame
+{
+	std::vector<PgnTag> tags;			// in file order
+	std::string startFen;				// FEN tag, or the standard starting position
+	std::vector<Move> moves;			// moves replayed from startFen, up to the first illegal one
+	std::string result;					// "1-0", "0-1", "1/2-1/2" or "*"
+	std::string error;					// first problem found in the movetext, empty if the game is valid
+
+	void clear();
+	const std::string* tag(const std::string& name) const;		// nullptr if the tag is missing
+};
+
+class PgnReader
+{
+	// Public Functions
+public:
+	// Constructor
+
+	PgnReader(size_t bufferSize = 1 << 20);
+
+	// Reading
+
+	bool open(const std::string& path);
+	void open(const char* text, size_t size);		// text must outlive the reader or the next open()
+	bool readGame(PgnGame& game);			// false once the file is exhausted, reuses the memory of game
+	uint64_t bytesRead() const;
+
+	// Private Functions
+private:
+	int peek();								// next character, -1 at the end of the file
+	int get();
+	bool refill();
+
+	void skipWhitespace();
+	void skipUntil(char end);
+	void skipVariation();
+	void readTag(PgnGame& game);
+	void readToken();
+	void playToken(PgnGame& game);
+
+	// Private Variables
+private:
+	std::ifstream file;
+	std::vector<char> buffer;				// fixed size, refilled from file as it is consumed
+	const char* data;						// buffer, or the text given to open()
+	size_t position;						// next unread character in data
+	size_t filled;							// characters in data
+	uint64_t consumed;						// characters of the file read before buffer
+	char token[256];						// current movetext token, long tokens are cut
+	size_t tokenLength;
+	Position board;							// replays the game being read
+};
+
+// Export
+
+PgnGame makePgnGame(const Game& game);						// Seven Tag Roster with unknown values, moves and result of game
+void writePgn(std::ostream& out, const PgnGame& game);		// tags, SAN movetext wrapped at 80 columns and the result
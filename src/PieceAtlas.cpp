@@ -0,0 +1,93 @@
+#include "PieceAtlas.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>			// for std::cerr
+
+// file names of the pieces in atlas column order, white then black
+static const char* pieceFiles[2][6] =
+{
+	{ "wK", "wQ", "wR", "wB", "wN", "wP" },
+	{ "bK", "bQ", "bR", "bB", "bN", "bP" },
+};
+
+// ------------------------------------------- PIECE SET -------------------------------------------
+
+sf::IntRect PieceSet::getRect(const int& piece) const
+{
+	int column = abs(piece) - 1;		// King (1) to Pawn (6)
+	int row = piece > 0 ? 0 : 1;		// white on top, black below
+
+	return sf::IntRect(column * cellSize, row * cellSize, cellSize, cellSize);
+}
+
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+PieceAtlas::PieceAtlas(const std::string& directory)
+{
+	this->directory = directory;
+}
+
+
+// Piece Sets
+
+const PieceSet* PieceAtlas::get(const std::string& theme)
+{
+	auto it = sets.find(theme);
+
+	if (it != sets.end())
+		return &it->second;
+
+	PieceSet& set = sets[theme];
+
+	if (!load(theme, set))
+	{
+		sets.erase(theme);
+		return nullptr;
+	}
+
+	return &set;
+}
+
+
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
+
+bool PieceAtlas::load(const std::string& theme, PieceSet& set)
+{
+	sf::Image images[2][6];
+	unsigned int cellSize = 0;
+
+	for (int row = 0; row < 2; ++row)
+	{
+		for (int column = 0; column < 6; ++column)
+		{
+			std::string path = directory + theme + "/" + pieceFiles[row][column] + ".png";
+
+			if (!images[row][column].loadFromFile(path))
+			{
+				std::cerr << "Error! Piece texture " << path << " not loaded! PieceAtlas::load()" << std::endl;
+				return false;
+			}
+
+			cellSize = std::max({ cellSize, images[row][column].getSize().x, images[row][column].getSize().y });
+		}
+	}
+
+	sf::Image atlas;
+	atlas.create(6 * cellSize, 2 * cellSize, sf::Color(0, 0, 0, 0));
+
+	for (int row = 0; row < 2; ++row)
+		for (int column = 0; column < 6; ++column)
+			atlas.copy(images[row][column], column * cellSize, row * cellSize);
+
+	if (!set.texture.loadFromImage(atlas))
+	{
+		std::cerr << "Error! Piece atlas for " << theme << " not created! PieceAtlas::load()" << std::endl;
+		return false;
+	}
+
+	set.cellSize = int(cellSize);
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "SFML/Graphics.hpp"
+#include <string>
+#include <unordered_map>
+
+// All twelve pieces of one theme packed into a single texture, kings to pawns from left to right,
+// white pieces on the top row and black pieces on the bottom row.
+
+struct PieceSet
+{
+	sf::Texture texture;			// atlas texture holding every piece of the theme
+	int cellSize;					// width and height (in pixels) of one piece in the atlas
+
+	sf::IntRect getRect(const int& piece) const;		// piece uses the signed codes of Position::pieceAt()
+};
+
+// Loads each piece theme from disk the first time it is asked for and keeps it for the rest of the
+// game, so drawing and switching back to a theme never touch the disk again.
+
+class PieceAtlas
+{
+	// Public Functions
+public:
+	// Constructor
+
+	PieceAtlas(const std::string& directory);
+
+	// Piece Sets
+
+	const PieceSet* get(const std::string& theme);		// nullptr if the theme could not be loaded
+
+	// Private Functions
+private:
+	bool load(const std::string& theme, PieceSet& set);
+
+	// Private Variables
+private:
+	std::string directory;								// folder containing one subfolder per theme
+	std::unordered_map<std::string, PieceSet> sets;		// themes loaded so far
+};
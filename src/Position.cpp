@@ -0,0 +1,687 @@
+#include "Position.h"
+#include "Movegen.h"
+#include <charconv>
+#include <cstdlib>
+
+// castling rights kept when a piece moves from or to each square
+
+static const int castlingMask[64] =
+{
+	~whiteQueenside, allCastling, allCastling, allCastling, ~(whiteKingside | whiteQueenside), allCastling, allCastling, ~whiteKingside,
+	allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling,
+	allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling,
+	allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling,
+	allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling,
+	allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling,
+	allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling, allCastling,
+	~blackQueenside, allCastling, allCastling, allCastling, ~(blackKingside | blackQueenside), allCastling, allCastling, ~blackKingside,
+};
+
+// FEN fields, each read without touching a Position
+
+static std::string_view nextField(std::string_view& fen)
+{
+	const char* spaces = " \t\r\n";
+	size_t start = fen.find_first_not_of(spaces);
+
+	if (start == std::string_view::npos)
+	{
+		fen = std::string_view();
+		return fen;
+	}
+
+	fen.remove_prefix(start);
+	std::string_view field = fen.substr(0, fen.find_first_of(spaces));
+	fen.remove_prefix(field.size());
+	return field;
+}
+
+static bool readPieces(std::string_view str, int* board)
+{
+	int file = 0;
+	int rank = 7;		// FEN lists ranks from the eighth down
+
+	for (int s = 0; s < 64; ++s)
+		board[s] = 0;
+
+	for (char c : str)
+	{
+		if (c == '/')															// next rank, the last one must be full
+		{
+			if (file != 8 || rank == 0)
+				return false;
+
+			file = 0;
+			--rank;
+			continue;
+		}
+
+		if (c >= '1' && c <= '8')												// empty spaces
+		{
+			file += c - '0';
+
+			if (file > 8)
+				return false;
+
+			continue;
+		}
+
+		int piece = 0;
+
+		switch (c)
+		{
+		case 'K':	piece = king;		break;	// white King
+		case 'Q':	piece = queen;		break;	// white Queen
+		case 'R':	piece = rook;		break;	// white Rook
+		case 'B':	piece = bishop;		break;	// white Bishop
+		case 'N':	piece = knight;		break;	// white kNight
+		case 'P':	piece = pawn;		break;	// white Pawn
+		case 'k':	piece = -king;		break;	// black kING
+		case 'q':	piece = -queen;		break;	// black qUEEN
+		case 'r':	piece = -rook;		break;	// black rOOK
+		case 'b':	piece = -bishop;	break;	// black bISHOP
+		case 'n':	piece = -knight;	break;	// black KnIGHT
+		case 'p':	piece = -pawn;		break;	// black pAWN
+		}
+
+		if (!piece || file > 7)
+			return false;
+
+		board[makeSquare(file, rank)] = piece;
+		++file;
+	}
+
+	return file == 8 && rank == 0;
+}
+
+static bool readActiveColor(std::string_view str, Color& color)
+{
+	if (str != "w" && str != "b")
+		return false;
+
+	color = str == "w" ? white : black;
+	return true;
+}
+
+static bool readCastlingRights(std::string_view str, int& rights)
+{
+	if (str == "-")
+		return true;
+
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case 'K':
+			rights |= whiteKingside;
+			break;
+		case 'Q':
+			rights |= whiteQueenside;
+			break;
+		case 'k':
+			rights |= blackKingside;
+			break;
+		case 'q':
+			rights |= blackQueenside;
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	return !str.empty();
+}
+
+static bool readEnPassantTarget(std::string_view str, Color color, Square& ep)
+{
+	if (str == "-")
+		return true;
+
+	if (str.size() != 2 || str[0] < 'a' || str[0] > 'h' || str[1] != (color == white ? '6' : '3'))	// behind a pawn that just moved two
+		return false;
+
+	ep = makeSquare(str[0] - 'a', str[1] - '1');
+	return true;
+}
+
+static bool readCounter(std::string_view str, int& value)
+{
+	auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+	return result.ec == std::errc() && result.ptr == str.data() + str.size() && value >= 0;
+}
+
+static FenError checkPieces(const int* board, Color color)
+{
+	// one king each, no pawn on the first or last rank and no king that could be taken at once,
+	// which the move generator relies on
+
+	Bitboard pieces[13] = {};								// indexed by piece + 6
+
+	for (int s = 0; s < 64; ++s)
+		pieces[board[s] + 6] |= squareBB(Square(s));
+
+	if (popCount(pieces[king + 6]) != 1 || popCount(pieces[-king + 6]) != 1)
+		return fenInvalidKings;
+
+	if ((pieces[pawn + 6] | pieces[-pawn + 6]) & (rank1BB | rank8BB))
+		return fenPawnsOnBackRank;
+
+	int sign = color == white ? 1 : -1;						// pieces of the side to move
+	Square ksq = lsb(pieces[-sign * king + 6]);
+	Bitboard occupied = ~pieces[6];
+	Bitboard queens = pieces[sign * queen + 6];
+
+	if ((pawnAttacks(Color(!color), ksq) & pieces[sign * pawn + 6]) || (knightAttacks(ksq) & pieces[sign * knight + 6]) ||
+		(kingAttacks(ksq) & pieces[sign * king + 6]) || (bishopAttacks(ksq, occupied) & (pieces[sign * bishop + 6] | queens)) ||
+		(rookAttacks(ksq, occupied) & (pieces[sign * rook + 6] | queens)))
+		return fenOpponentInCheck;
+
+	return fenOk;
+}
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+Position::Position()
+{
+	initBitboards();
+	clear();
+}
+
+
+// FEN
+
+const char* fenErrorText(FenError error)
+{
+	switch (error)
+	{
+	case fenOk:					return "valid";
+	case fenInvalidBoard:		return "invalid board";
+	case fenInvalidKings:		return "not one king of each color";
+	case fenPawnsOnBackRank:	return "pawn on the first or last rank";
+	case fenOpponentInCheck:	return "side not to move is in check";
+	case fenInvalidColor:		return "invalid active color";
+	case fenInvalidCastling:	return "invalid castling rights";
+	case fenInvalidEnPassant:	return "invalid en passant target";
+	case fenInvalidHalfMoves:	return "invalid halfmove clock";
+	case fenInvalidFullMoves:	return "invalid fullmove number";
+	case fenTooManyFields:		return "too many fields";
+	}
+
+	return "unknown error";
+}
+
+FenError Position::loadFen(std::string_view fen)
+{
+	// every field is read into locals first, so a bad FEN leaves the position as it was
+
+	std::string_view rest = fen;
+	int board[64];
+	Color color = white;
+	int rights = noCastling;
+	Square ep = noSquare;
+	int halfMoveClock = 0;
+	int fullMoveNumber = 1;
+
+	if (!readPieces(nextField(rest), board))
+		return fenInvalidBoard;
+
+	if (!readActiveColor(nextField(rest), color))
+		return fenInvalidColor;
+
+	FenError error = checkPieces(board, color);
+
+	if (error != fenOk)
+		return error;
+
+	if (!readCastlingRights(nextField(rest), rights))
+		return fenInvalidCastling;
+
+	if (!readEnPassantTarget(nextField(rest), color, ep))
+		return fenInvalidEnPassant;
+
+	std::string_view counter = nextField(rest);					// move counters are optional, e.g. in EPD records
+
+	if (!counter.empty() && !readCounter(counter, halfMoveClock))
+		return fenInvalidHalfMoves;
+
+	counter = nextField(rest);
+
+	if (!counter.empty() && (!readCounter(counter, fullMoveNumber) || fullMoveNumber < 1))
+		return fenInvalidFullMoves;
+
+	if (!nextField(rest).empty())
+		return fenTooManyFields;
+
+	clear();
+
+	for (int s = 0; s < 64; ++s)
+		if (board[s])
+			putPiece(board[s], Square(s));
+
+	activeColor = color;
+	castling = rights;
+	epSquare = ep != noSquare && (pawnAttacks(Color(!color), ep) & pieces(color, pawn)) ? ep : noSquare;	// as makeMove keeps it, so keys match
+	halfMoves = halfMoveClock;
+	fullMoves = fullMoveNumber;
+	key = computeKey();
+	return fenOk;
+}
+
+size_t Position::writeFen(char* buffer) const
+{
+	static const char pieceChars[] = "pnbrqk KQRBNP";					// indexed by piece + 6
+
+	char* out = buffer;
+
+	for (int rank = 7; rank >= 0; --rank)
+	{
+		int empty = 0;
+
+		for (int file = 0; file < 8; ++file)
+		{
+			int piece = squares[makeSquare(file, rank)];
+
+			if (!piece)
+			{
+				++empty;
+				continue;
+			}
+
+			if (empty)
+				*out++ = char('0' + empty);
+
+			empty = 0;
+			*out++ = pieceChars[piece + 6];
+		}
+
+		if (empty)
+			*out++ = char('0' + empty);
+
+		if (rank)
+			*out++ = '/';
+	}
+
+	*out++ = ' ';
+	*out++ = activeColor == white ? 'w' : 'b';
+	*out++ = ' ';
+
+	if (!castling)
+		*out++ = '-';
+
+	if (castling & whiteKingside)
+		*out++ = 'K';
+
+	if (castling & whiteQueenside)
+		*out++ = 'Q';
+
+	if (castling & blackKingside)
+		*out++ = 'k';
+
+	if (castling & blackQueenside)
+		*out++ = 'q';
+
+	*out++ = ' ';
+
+	if (epSquare == noSquare)
+		*out++ = '-';
+	else
+	{
+		*out++ = char('a' + fileOf(epSquare));
+		*out++ = char('1' + rankOf(epSquare));
+	}
+
+	*out++ = ' ';
+	out = std::to_chars(out, buffer + maxFenLength, halfMoves).ptr;
+	*out++ = ' ';
+	out = std::to_chars(out, buffer + maxFenLength, fullMoves).ptr;
+	*out = '\0';
+	return size_t(out - buffer);
+}
+
+std::string Position::toFen() const
+{
+	char buffer[maxFenLength];
+	return std::string(buffer, writeFen(buffer));
+}
+
+
+// Setup
+
+void Position::clear()
+{
+	for (int s = 0; s < 64; ++s)
+		squares[s] = 0;
+
+	for (int pt = 0; pt < 7; ++pt)
+		byType[pt] = 0;
+
+	byColor[white] = 0;
+	byColor[black] = 0;
+
+	activeColor = white;
+	castling = noCastling;
+	epSquare = noSquare;
+	halfMoves = 0;
+	fullMoves = 1;
+	key = 0;
+	mgScore = 0;
+	egScore = 0;
+	phase = 0;
+	nnueReset(accumulator);
+}
+
+void Position::putPiece(int piece, Square s)
+{
+	if (squares[s])
+		removePiece(s);
+
+	if (!piece)
+		return;
+
+	squares[s] = piece;
+	key ^= pieceKey(piece, s);
+	mgScore += psqtMgValue(piece, s);
+	egScore += psqtEgValue(piece, s);
+	phase += phaseWeights[abs(piece)];
+
+	if (hasNnue())
+		nnueAdd(accumulator, piece, s);
+
+	byType[abs(piece)] |= squareBB(s);
+	byColor[piece > 0 ? white : black] |= squareBB(s);
+}
+
+void Position::setSideToMove(Color c)
+{
+	if (c != activeColor)
+		key ^= sideKey;
+
+	activeColor = c;
+}
+
+void Position::setCastlingRights(int rights)
+{
+	key ^= castlingKeys[castling] ^ castlingKeys[rights];
+	castling = rights;
+}
+
+void Position::setEnPassantSquare(Square s)
+{
+	if (epSquare != noSquare)
+		key ^= enPassantKeys[fileOf(epSquare)];
+
+	if (s != noSquare)
+		key ^= enPassantKeys[fileOf(s)];
+
+	epSquare = s;
+}
+
+void Position::setMoveCounters(int halfMoveClock, int fullMoveNumber)
+{
+	halfMoves = halfMoveClock;
+	fullMoves = fullMoveNumber;
+}
+
+
+// Pieces
+
+Square Position::kingSquare(Color c) const
+{
+	Bitboard kings = pieces(c, king);
+	return kings ? lsb(kings) : noSquare;
+}
+
+
+// Evaluation
+
+void Position::refreshAccumulator()
+{
+	if (accumulator.network == nnueNetworkId())
+		return;
+
+	nnueReset(accumulator);
+
+	if (!hasNnue())
+		return;
+
+	for (int s = 0; s < 64; ++s)
+		if (squares[s])
+			nnueAdd(accumulator, squares[s], Square(s));
+}
+
+
+// Attacks
+
+Bitboard Position::attackersTo(Square s, Bitboard occupancy) const
+{
+	return (pawnAttacks(black, s) & pieces(white, pawn))						// a white pawn attacks s from where a black pawn on s would attack
+		| (pawnAttacks(white, s) & pieces(black, pawn))
+		| (knightAttacks(s) & byType[knight])
+		| (kingAttacks(s) & byType[king])
+		| (bishopAttacks(s, occupancy) & (byType[bishop] | byType[queen]))
+		| (rookAttacks(s, occupancy) & (byType[rook] | byType[queen]));
+}
+
+Bitboard Position::attacksBy(Color c) const
+{
+	Bitboard attacks = 0;
+	Bitboard attackers = byColor[c];
+
+	while (attackers)
+		attacks |= pieceAttacks(popLsb(attackers));
+
+	return attacks;
+}
+
+bool Position::isAttacked(Square s, Color by) const
+{
+	return attackersTo(s, occupied()) & byColor[by];
+}
+
+bool Position::inCheck() const
+{
+	Square ksq = kingSquare(activeColor);
+	return ksq != noSquare && isAttacked(ksq, Color(!activeColor));
+}
+
+bool Position::hasInsufficientMaterial() const
+{
+	if (byType[pawn] | byType[rook] | byType[queen])
+		return false;
+
+	Bitboard minors = byType[knight] | byType[bishop];
+
+	if (popCount(minors) <= 1)													// bare kings or a single minor piece
+		return true;
+
+	Bitboard bishops = byType[bishop];											// any number of bishops all on one square color
+	return minors == bishops && (!(bishops & darkSquaresBB) || !(bishops & ~darkSquaresBB));
+}
+
+
+// Moves
+
+void Position::makeMove(const Move& move, UndoInfo& undo)
+{
+	Color us = activeColor;
+	int piece = squares[move.from()];
+
+	undo.captured = squares[move.to()];
+	undo.castling = castling;
+	undo.epSquare = epSquare;
+	undo.halfMoves = halfMoves;
+	undo.key = key;
+
+	++halfMoves;
+
+	if (abs(piece) == pawn)
+	{
+		halfMoves = 0;
+
+		if (move.flag() == enPassantMove)										// en passant removes the pawn behind the target square
+		{
+			Square captureSquare = makeSquare(fileOf(move.to()), rankOf(move.from()));
+			undo.captured = squares[captureSquare];
+			removePiece(captureSquare);
+		}
+	}
+
+	if (move.flag() == castlingMove)												// castling also moves the rook
+	{
+		bool kingside = move.to() > move.from();
+		movePiece(Square(kingside ? move.from() + 3 : move.from() - 4), Square(kingside ? move.from() + 1 : move.from() - 1));
+	}
+
+	if (undo.captured)
+		halfMoves = 0;
+
+	movePiece(move.from(), move.to());
+
+	if (move.promotion())
+		putPiece(us == white ? move.promotion() : -move.promotion(), move.to());
+
+	if (epSquare != noSquare)
+		key ^= enPassantKeys[fileOf(epSquare)];
+
+	epSquare = noSquare;
+
+	if (abs(piece) == pawn && abs(move.to() - move.from()) == 16)					// double push, target kept only if a pawn can capture
+	{
+		Square target = Square((move.from() + move.to()) / 2);
+
+		if (pawnAttacks(us, target) & pieces(Color(!us), pawn))
+		{
+			epSquare = target;
+			key ^= enPassantKeys[fileOf(target)];
+		}
+	}
+
+	key ^= castlingKeys[castling];
+	castling &= castlingMask[move.from()] & castlingMask[move.to()];
+	key ^= castlingKeys[castling];
+
+	if (us == black)
+		++fullMoves;
+
+	activeColor = Color(!us);
+	key ^= sideKey;
+}
+
+void Position::unmakeMove(const Move& move, const UndoInfo& undo)
+{
+	activeColor = Color(!activeColor);
+	Color us = activeColor;
+
+	if (us == black)
+		--fullMoves;
+
+	int piece = move.promotion() ? (us == white ? pawn : -pawn) : squares[move.to()];
+
+	removePiece(move.to());
+	putPiece(piece, move.from());
+
+	if (move.flag() == castlingMove)												// put the castled rook back
+	{
+		bool kingside = move.to() > move.from();
+		movePiece(Square(kingside ? move.from() + 1 : move.from() - 1), Square(kingside ? move.from() + 3 : move.from() - 4));
+	}
+
+	if (move.flag() == enPassantMove)												// en passant pawn was behind the target square
+		putPiece(undo.captured, makeSquare(fileOf(move.to()), rankOf(move.from())));
+	else if (undo.captured)
+		putPiece(undo.captured, move.to());
+
+	castling = undo.castling;
+	epSquare = undo.epSquare;
+	halfMoves = undo.halfMoves;
+	key = undo.key;
+}
+
+Bitboard Position::legalMoves(Square from) const
+{
+	MoveList moves;
+	generateLegalMoves(*this, moves);
+
+	Bitboard destinations = 0;
+
+	for (const Move& move : moves)
+		if (move.from() == from)
+			destinations |= squareBB(move.to());									// promotion choices share a square
+
+	return destinations;
+}
+
+bool Position::hasLegalMoves() const
+{
+	MoveList moves;
+	generateLegalMoves(*this, moves);
+	return !moves.empty();
+}
+
+
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
+
+// Hashing
+
+Key Position::computeKey() const
+{
+	Key k = castlingKeys[castling];
+
+	for (int s = 0; s < 64; ++s)
+		k ^= pieceKey(squares[s], Square(s));
+
+	if (epSquare != noSquare)
+		k ^= enPassantKeys[fileOf(epSquare)];
+
+	if (activeColor == black)
+		k ^= sideKey;
+
+	return k;
+}
+
+
+// Pieces
+
+void Position::removePiece(Square s)
+{
+	int piece = squares[s];
+
+	key ^= pieceKey(piece, s);
+	mgScore -= psqtMgValue(piece, s);
+	egScore -= psqtEgValue(piece, s);
+	phase -= phaseWeights[abs(piece)];
+
+	if (hasNnue())
+		nnueRemove(accumulator, piece, s);
+
+	byType[abs(piece)] &= ~squareBB(s);
+	byColor[piece > 0 ? white : black] &= ~squareBB(s);
+	squares[s] = 0;
+}
+
+void Position::movePiece(Square from, Square to)
+{
+	int piece = squares[from];
+
+	removePiece(from);
+	putPiece(piece, to);
+}
+
+Bitboard Position::pieceAttacks(Square s) const
+{
+	int piece = squares[s];
+
+	switch (abs(piece))
+	{
+	case king:		return kingAttacks(s);
+	case queen:		return queenAttacks(s, occupied());
+	case rook:		return rookAttacks(s, occupied());
+	case bishop:	return bishopAttacks(s, occupied());
+	case knight:	return knightAttacks(s);
+	case pawn:		return pawnAttacks(piece > 0 ? white : black, s);
+	default:		return 0;
+	}
+}
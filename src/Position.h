@@ -0,0 +1,137 @@
+#pragma once
+#include "Magic.h"
+#include "Move.h"
+#include "Nnue.h"
+#include "Psqt.h"
+#include "Zobrist.h"
+#include <string>
+#include <string_view>
+
+const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+const size_t maxFenLength = 104;			// longest FEN writeFen() can produce, terminator included
+
+enum FenError
+{
+	fenOk,
+	fenInvalidBoard,
+	fenInvalidKings,				// not exactly one king of each color
+	fenPawnsOnBackRank,
+	fenOpponentInCheck,				// the side that just moved left its king attacked
+	fenInvalidColor,
+	fenInvalidCastling,
+	fenInvalidEnPassant,
+	fenInvalidHalfMoves,
+	fenInvalidFullMoves,
+	fenTooManyFields
+};
+
+const char* fenErrorText(FenError error);
+
+enum CastlingRights
+{
+	noCastling = 0,
+	whiteKingside = 1,
+	whiteQueenside = 2,
+	blackKingside = 4,
+	blackQueenside = 8,
+	allCastling = 15
+};
+
+class Position
+{
+	// Public Functions
+public:
+	// Constructor
+
+	Position();
+
+	// FEN
+
+	FenError loadFen(std::string_view fen);			// the position is unchanged unless fenOk is returned, an en passant target no pawn can take is dropped
+	size_t writeFen(char* buffer) const;			// buffer of maxFenLength chars, returns the length without the terminator
+	std::string toFen() const;
+
+	// Setup
+
+	void clear();
+	void putPiece(int piece, Square s);				// piece uses the signed codes of pieceAt()
+	void setSideToMove(Color c);
+	void setCastlingRights(int rights);
+	void setEnPassantSquare(Square s);
+	void setMoveCounters(int halfMoveClock, int fullMoveNumber);
+
+	// Pieces
+
+	int pieceAt(Square s) const						{ return squares[s]; }
+	Bitboard occupied() const						{ return byColor[white] | byColor[black]; }
+	Bitboard pieces(Color c) const					{ return byColor[c]; }
+	Bitboard pieces(Color c, PieceType pt) const	{ return byColor[c] & byType[pt]; }
+	Square kingSquare(Color c) const;
+
+	// State
+
+	Color sideToMove() const						{ return activeColor; }
+	int castlingRights() const						{ return castling; }
+	Square enPassantSquare() const					{ return epSquare; }
+	int halfMoveClock() const						{ return halfMoves; }
+	int fullMoveNumber() const						{ return fullMoves; }
+	Key hash() const								{ return key; }
+
+	// Evaluation
+
+	int midgameScore() const						{ return mgScore; }		// piece-square sums, white minus black
+	int endgameScore() const						{ return egScore; }
+	int gamePhase() const							{ return phase; }		// maxPhase at the start, falls as pieces are traded
+
+	const Accumulator& nnueAccumulator() const		{ return accumulator; }
+	bool hasNnue() const							{ return accumulator.network && accumulator.network == nnueNetworkId(); }
+	void refreshAccumulator();						// rebuilds the hidden layer sums after a network was loaded
+
+	// Attacks
+
+	Bitboard attackersTo(Square s, Bitboard occupancy) const;
+	Bitboard attacksBy(Color c) const;
+	bool isAttacked(Square s, Color by) const;
+	bool inCheck() const;
+	bool hasInsufficientMaterial() const;			// neither side can mate with any sequence of moves
+
+	// Moves
+
+	void makeMove(const Move& move, UndoInfo& undo);
+	void unmakeMove(const Move& move, const UndoInfo& undo);
+
+	Bitboard legalMoves(Square from) const;
+	bool hasLegalMoves() const;
+
+	// Private Functions
+private:
+	// Hashing
+
+	Key computeKey() const;
+
+	// Pieces
+
+	void removePiece(Square s);
+	void movePiece(Square from, Square to);
+
+	Bitboard pieceAttacks(Square s) const;
+
+	// Private Variables
+private:
+	int squares[64];				// piece on each square, a1 = 0 and h8 = 63, PieceType positive for white and negative for black
+	Bitboard byType[7];				// squares occupied by each piece type of both colors, indexed by PieceType
+	Bitboard byColor[2];			// squares occupied by each color
+
+	Color activeColor;				// side to move
+	int castling;					// CastlingRights flags still available
+	Square epSquare;				// en passant target square, noSquare if none
+	int halfMoves;					// halfmove clock for the fifty move rule
+	int fullMoves;					// full move number, incremented after black moves
+	Key key;						// Zobrist hash of all of the above except the move counters
+
+	int mgScore;					// middlegame piece-square sum, updated with every piece put or removed
+	int egScore;					// endgame piece-square sum
+	int phase;						// sum of phaseWeights of the pieces on the board
+
+	Accumulator accumulator;		// network hidden layer, only kept up to date while hasNnue()
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "Bitboard.h"
+
+// Piece-square tables with the piece values included, one for the middlegame and one for the
+// endgame. Position adds up both sums as pieces are put and removed, and the evaluation blends them
+// by game phase, so a position is never scanned square by square to be evaluated.
+
+extern int psqtMg[13][64];						// indexed by signed piece code + 6 and square, positive for white
+extern int psqtEg[13][64];
+
+const int phaseWeights[7] = { 0, 0, 4, 2, 1, 1, 0 };	// indexed by PieceType, minor and major pieces left on the board
+const int maxPhase = 24;						// phase of the starting position, 0 is a pawn endgame
+
+void initPsqt();								// called by initBitboards()
+
+inline int psqtMgValue(int piece, Square s)		{ return psqtMg[piece + 6][s]; }
+inline int psqtEgValue(int piece, Square s)		{ return psqtEg[piece + 6][s]; }
@@ -0,0 +1,224 @@
+#include "San.h"
+#include <cstdlib>
+
+static const char pieceLetters[] = " KQRBNP";						// indexed by PieceType
+
+static PieceType pieceFromLetter(char c)
+{
+	switch (c)
+	{
+	case 'K':	return king;
+	case 'Q':	return queen;
+	case 'R':	return rook;
+	case 'B':	return bishop;
+	case 'N':	return knight;
+	default:	return noPieceType;
+	}
+}
+
+// Pieces of one kind and colour that attack a square, read off the attack tables
+
+static Bitboard attackersOf(const Position& pos, Color c, PieceType pt, Square s)
+{
+	Bitboard occupied = pos.occupied();
+
+	switch (pt)
+	{
+	case king:		return kingAttacks(s) & pos.pieces(c, king);
+	case queen:		return queenAttacks(s, occupied) & pos.pieces(c, queen);
+	case rook:		return rookAttacks(s, occupied) & pos.pieces(c, rook);
+	case bishop:	return bishopAttacks(s, occupied) & pos.pieces(c, bishop);
+	case knight:	return knightAttacks(s) & pos.pieces(c, knight);
+	default:		return 0;
+	}
+}
+
+// ------------------------------------------- ENCODING -------------------------------------------
+
+std::string moveToSan(const Position& pos, const Move& move)
+{
+	std::string san;
+	Square from = move.from();
+	Square to = move.to();
+	PieceType pt = PieceType(abs(pos.pieceAt(from)));
+	bool capture = pos.pieceAt(to) || move.flag() == enPassantMove;
+
+	if (move.flag() == castlingMove)
+		san = to > from ? "O-O" : "O-O-O";
+	else if (pt == pawn)
+	{
+		if (capture)
+			san += { char('a' + fileOf(from)), 'x' };
+
+		san += { char('a' + fileOf(to)), char('1' + rankOf(to)) };
+
+		if (move.promotion())
+			san += { '=', pieceLetters[move.promotion()] };
+	}
+	else
+	{
+		san += pieceLetters[pt];
+
+		// other pieces of the same kind that can also go to the destination, pinned ones do not count
+
+		Bitboard others = attackersOf(pos, pos.sideToMove(), pt, to) & ~squareBB(from);
+		bool ambiguous = false, sameFile = false, sameRank = false;
+
+		while (others)
+		{
+			Square other = popLsb(others);
+
+			if (!isLegalMove(pos, Move(other, to)))
+				continue;
+
+			ambiguous = true;
+			sameFile |= fileOf(other) == fileOf(from);
+			sameRank |= rankOf(other) == rankOf(from);
+		}
+
+		if (ambiguous && (!sameFile || sameRank))					// the file is enough unless another piece shares it
+			san += char('a' + fileOf(from));
+
+		if (ambiguous && sameFile)
+			san += char('1' + rankOf(from));
+
+		if (capture)
+			san += 'x';
+
+		san += { char('a' + fileOf(to)), char('1' + rankOf(to)) };
+	}
+
+	if (givesCheck(pos, move))										// only a check needs the move played to tell mate
+	{
+		Position after = pos;
+		UndoInfo undo;
+		after.makeMove(move, undo);
+		san += after.hasLegalMoves() ? '+' : '#';
+	}
+
+	return san;
+}
+
+
+// ------------------------------------------- DECODING -------------------------------------------
+
+Move sanToMove(const Position& pos, std::string_view san)
+{
+	while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+		san.remove_suffix(1);
+
+	Color us = pos.sideToMove();
+
+	if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
+	{
+		Square ksq = pos.kingSquare(us);
+		Move castling(ksq, Square(san.size() == 3 ? ksq + 2 : ksq - 2), castlingMove);
+		return ksq != noSquare && isLegalMove(pos, castling) ? castling : Move();
+	}
+
+	// piece letter, destination and promotion from the ends, whatever is left in between narrows the origin
+
+	PieceType pt = pawn;
+	PieceType promotion = noPieceType;
+
+	if (!san.empty() && pieceFromLetter(san.front()))
+	{
+		pt = pieceFromLetter(san.front());
+		san.remove_prefix(1);
+	}
+
+	if (!san.empty() && pt == pawn && pieceFromLetter(san.back()))
+	{
+		promotion = pieceFromLetter(san.back());
+		san.remove_suffix(1);
+
+		if (!san.empty() && san.back() == '=')
+			san.remove_suffix(1);
+	}
+
+	if (san.size() < 2 || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h' || san.back() < '1' || san.back() > '8')
+		return Move();
+
+	Square to = makeSquare(san[san.size() - 2] - 'a', san.back() - '1');
+	san.remove_suffix(2);
+
+	int fromFile = -1, fromRank = -1;
+	bool capture = false;
+
+	for (char c : san)
+	{
+		if (c >= 'a' && c <= 'h')
+			fromFile = c - 'a';
+		else if (c >= '1' && c <= '8')
+			fromRank = c - '1';
+		else if (c == 'x')
+			capture = true;
+		else if (c != '-')
+			return Move();
+	}
+
+	if (pos.pieces(us) & squareBB(to))
+		return Move();
+
+	// candidate origins: pieces attacking the destination, pawns pushing or capturing onto it
+
+	Bitboard candidates;
+	bool enPassant = false;
+
+	if (pt == pawn)
+	{
+		int forward = us == white ? 8 : -8;
+		Bitboard lastRank = us == white ? rank8BB : rank1BB;
+
+		if ((promotion != noPieceType) != bool(lastRank & squareBB(to)) || promotion == king)
+			return Move();
+
+		bool target = pos.pieceAt(to) || to == pos.enPassantSquare();
+
+		if (capture != target || (capture && fromFile < 0))				// a pawn capture is always written exd5, a push never
+			return Move();
+
+		if (capture)
+		{
+			candidates = pawnAttacks(Color(!us), to) & pos.pieces(us, pawn);
+			enPassant = !pos.pieceAt(to);
+		}
+		else
+		{
+			if (rankOf(to) == (us == white ? 0 : 7))
+				return Move();
+
+			Square oneBack = Square(to - forward);
+			candidates = pos.pieces(us, pawn) & squareBB(oneBack);
+
+			if (!candidates && !pos.pieceAt(oneBack) && rankOf(to) == (us == white ? 3 : 4))	// double push
+				candidates = pos.pieces(us, pawn) & squareBB(Square(oneBack - forward));
+		}
+	}
+	else
+		candidates = promotion ? 0 : attackersOf(pos, us, pt, to);
+
+	if (fromFile >= 0)
+		candidates &= fileABB << fromFile;
+
+	if (fromRank >= 0)
+		candidates &= rank1BB << (8 * fromRank);
+
+	Move found;
+
+	while (candidates)
+	{
+		Square from = popLsb(candidates);
+		Move move = enPassant ? Move(from, to, enPassantMove) : Move(from, to, promotion);
+
+		if (!isLegalMove(pos, move))
+			continue;
+
+		if (!found.isNone())										// ambiguous
+			return Move();
+
+		found = move;
+	}
+
+	return found;
+}
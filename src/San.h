@@ -0,0 +1,13 @@
+#pragma once
+#include "Movegen.h"
+#include <string>
+#include <string_view>
+
+// Standard algebraic notation, e.g. Nf3, exd5, Rad1, O-O or e8=Q+, as used by PGN files.
+
+std::string moveToSan(const Position& pos, const Move& move);		// move must be legal in pos
+Move sanToMove(const Position& pos, std::string_view san);			// Move() if san is not a legal move in pos
+
+// sanToMove() accepts missing or wrong check marks, annotations such as ! or ?, 0-0 for O-O and
+// promotions without the = sign, as all of them turn up in real game files. A pawn capture must
+// name its file and the x, so e5 is never read as dxe5.
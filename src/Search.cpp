@@ -0,0 +1,427 @@
+#include "Search.h"
+#include <cstdlib>
+
+// ordering scores, each class of moves is tried before the next
+const int hashBonus = 1 << 30;
+const int pvBonus = 1 << 29;
+const int captureBonus = 1 << 28;
+const int firstKillerBonus = 1 << 27;
+const int secondKillerBonus = firstKillerBonus - 1;
+
+// mate scores are stored relative to the position, not to the root
+
+static int scoreToTT(int score, int ply)
+{
+	return score >= mateScore - maxPly ? score + ply : score <= -mateScore + maxPly ? score - ply : score;
+}
+
+static int scoreFromTT(int score, int ply)
+{
+	return score >= mateScore - maxPly ? score - ply : score <= -mateScore + maxPly ? score + ply : score;
+}
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+Search::Search(TranspositionTable& tt, SearchShared& shared, int threadId) : tt(tt), shared(shared)
+{
+	this->threadId = threadId;
+	rootDepth = 0;
+	nodes = 0;
+}
+
+
+// Searching
+
+SearchInfo Search::think(const Position& position, const SearchLimits& limits, const std::vector<Key>& gameHistory)
+{
+	pos = position;
+	keyStack.assign(gameHistory.begin(), gameHistory.end());
+	keyStack.reserve(gameHistory.size() + maxPly);
+	pos.refreshAccumulator();								// the position may predate the network
+	this->limits = limits;
+	start = std::chrono::steady_clock::now();
+	nodes = 0;
+
+	for (int ply = 0; ply < maxPly; ++ply)
+	{
+		killers[ply][0] = killers[ply][1] = Move();
+		previousPv[ply] = Move();
+	}
+
+	for (int c = 0; c < 2; ++c)
+		for (int from = 0; from < 64; ++from)
+			for (int to = 0; to < 64; ++to)
+				history[c][from][to] = 0;
+
+	SearchInfo info;
+
+	for (rootDepth = 1; rootDepth <= limits.depth && rootDepth < maxPly; ++rootDepth)
+	{
+		// helpers move on to the next depth when half of the threads are already searching this one
+
+		if (threadId > 0 && rootDepth > 1 && rootDepth < limits.depth && shared.threadsAtDepth[rootDepth] >= (shared.threadCount + 1) / 2)
+			continue;
+
+		++shared.threadsAtDepth[rootDepth];
+		int score = negamax(-infiniteScore, infiniteScore, rootDepth, 0);
+		--shared.threadsAtDepth[rootDepth];
+
+		if (shared.stop)									// unfinished iteration, never reported
+		{
+			if (info.pv.empty() && pvLength[0] > 0)			// but a root move it searched fully beats no move at all
+				info.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+
+			break;
+		}
+
+		info.depth = rootDepth;
+		info.score = score;
+		info.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+		info.nodes = nodes;
+		info.time = elapsed();
+		info.nps = nodes * 1000 / (info.time > 0 ? info.time : 1);
+
+		for (int ply = 0; ply < pvLength[0]; ++ply)
+			previousPv[ply] = pvTable[0][ply];
+
+		if (callback)
+			callback(info);
+
+		if (info.pv.empty())								// no legal moves
+			break;
+
+		if (abs(score) >= mateScore - rootDepth)			// a forced mate was found, deeper searches cannot improve it
+			break;
+	}
+
+	if (info.pv.empty())									// stopped before a root move was searched: the hash move, else the best evaluated one
+	{
+		TTEntry entry;
+		bool hashHit = tt.probe(pos.hash(), entry);
+		MoveList& moves = moveLists[0];
+		generateLegalMoves(pos, moves);
+
+		Move bestMove;
+		int bestScore = -infiniteScore;
+		UndoInfo undo;
+
+		for (const Move& move : moves)
+		{
+			if (hashHit && move == entry.move)
+			{
+				bestMove = move;
+				break;
+			}
+
+			pos.makeMove(move, undo);
+			int score = -evaluate(pos);
+			pos.unmakeMove(move, undo);
+
+			if (score > bestScore)
+			{
+				bestScore = score;
+				bestMove = move;
+			}
+		}
+
+		if (!bestMove.isNone())
+			info.pv.push_back(bestMove);
+	}
+
+	info.nodes = nodes;
+	info.time = elapsed();
+	info.nps = nodes * 1000 / (info.time > 0 ? info.time : 1);
+
+	return info;
+}
+
+void Search::stop()
+{
+	shared.stop = true;
+}
+
+void Search::onIteration(const std::function<void(const SearchInfo&)>& callback)
+{
+	this->callback = callback;
+}
+
+uint64_t Search::getNodes() const
+{
+	return nodes.load(std::memory_order_relaxed);
+}
+
+
+// ------------------------------------------- PRIVATE FUNCTIONS -------------------------------------------
+
+// Searching
+
+int Search::negamax(int alpha, int beta, int depth, int ply)
+{
+	pvLength[ply] = ply;
+
+	if (ply >= maxPly - 1)
+		return evaluate(pos);
+
+	bool inCheck = pos.inCheck();
+
+	if (inCheck)											// check extension, so mates behind checks are not cut off
+		++depth;
+
+	if (ply > 0 && (pos.halfMoveClock() >= 100 || isRepetition()))		// fifty move rule, or a repetition the opponent can force again, also on the last ply
+		return 0;
+
+	if (depth <= 0)
+		return quiescence(alpha, beta, ply);
+
+	if (shouldStop())
+		return 0;
+
+	int originalAlpha = alpha;
+	Move hashMove;
+	TTEntry entry;
+
+	if (tt.probe(pos.hash(), entry))
+	{
+		hashMove = entry.move;
+		int score = scoreFromTT(entry.score, ply);
+
+		if (ply > 0 && entry.depth >= depth && (entry.bound == exactBound ||
+			(entry.bound == lowerBound && score >= beta) || (entry.bound == upperBound && score <= alpha)))
+			return score;
+	}
+
+	MoveList& moves = moveLists[ply];
+	generateLegalMoves(pos, moves);
+
+	if (moves.empty())
+		return inCheck ? -mateScore + ply : 0;				// checkmate or stalemate
+
+	int* scores = scoreLists[ply];
+	scoreMoves(moves, ply, hashMove, scores);
+
+	int bestScore = -infiniteScore;
+	Move bestMove;
+	UndoInfo undo;
+
+	for (size_t i = 0; i < moves.size(); ++i)
+	{
+		pickMove(moves, scores, i);
+		Move move = moves[i];
+		bool quiet = !isCapture(move) && !move.promotion();
+
+		keyStack.push_back(pos.hash());
+		pos.makeMove(move, undo);
+		int score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+		pos.unmakeMove(move, undo);
+		keyStack.pop_back();
+
+		if (shared.stop)
+			return 0;
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestMove = move;
+		}
+
+		if (score > alpha)
+		{
+			alpha = score;
+			updatePv(move, ply);
+
+			if (alpha >= beta)								// refutation found, the opponent will avoid this line
+			{
+				if (quiet)
+					updateQuietStats(move, depth, ply);
+
+				break;
+			}
+		}
+	}
+
+	Bound bound = bestScore >= beta ? lowerBound : bestScore > originalAlpha ? exactBound : upperBound;
+	tt.store(pos.hash(), bound == upperBound ? Move() : bestMove, scoreToTT(bestScore, ply), depth, bound);
+
+	return bestScore;
+}
+
+int Search::quiescence(int alpha, int beta, int ply)
+{
+	pvLength[ply] = ply;
+
+	if (shouldStop())
+		return 0;
+
+	if (ply >= maxPly - 1)
+		return evaluate(pos);
+
+	bool inCheck = pos.inCheck();
+	int bestScore = -infiniteScore;
+
+	if (!inCheck)											// standing pat, the side to move is not forced to capture
+	{
+		bestScore = evaluate(pos);
+
+		if (bestScore >= beta)
+			return bestScore;
+
+		if (bestScore > alpha)
+			alpha = bestScore;
+	}
+
+	MoveList& moves = moveLists[ply];
+
+	if (inCheck)											// every evasion, or mates would be missed
+		generateLegalMoves(pos, moves);
+	else
+		generateLegalCaptures(pos, moves);
+
+	if (inCheck && moves.empty())
+		return -mateScore + ply;
+
+	int* scores = scoreLists[ply];
+	scoreMoves(moves, ply, Move(), scores);
+
+	UndoInfo undo;
+
+	for (size_t i = 0; i < moves.size(); ++i)
+	{
+		pickMove(moves, scores, i);
+		Move move = moves[i];
+
+		pos.makeMove(move, undo);
+		int score = -quiescence(-beta, -alpha, ply + 1);
+		pos.unmakeMove(move, undo);
+
+		if (shared.stop)
+			return 0;
+
+		if (score > bestScore)
+			bestScore = score;
+
+		if (score > alpha)
+		{
+			alpha = score;
+			updatePv(move, ply);
+
+			if (alpha >= beta)
+				break;
+		}
+	}
+
+	return bestScore;
+}
+
+
+// Move Ordering
+
+void Search::scoreMoves(const MoveList& moves, int ply, const Move& hashMove, int* scores) const
+{
+	Color us = pos.sideToMove();
+
+	for (size_t i = 0; i < moves.size(); ++i)
+	{
+		const Move& move = moves[i];
+
+		if (move == hashMove)
+			scores[i] = hashBonus;
+		else if (move == previousPv[ply])
+			scores[i] = pvBonus;
+		else if (isCapture(move) || move.promotion())				// most valuable victim first, then least valuable attacker
+		{
+			int victim = pos.pieceAt(move.to()) ? abs(pos.pieceAt(move.to())) : move.promotion() ? noPieceType : pawn;
+			int attacker = abs(pos.pieceAt(move.from()));
+			scores[i] = captureBonus + 10 * (pieceValues[victim] + pieceValues[move.promotion()]) - pieceValues[attacker] / 10;
+		}
+		else if (move == killers[ply][0])
+			scores[i] = firstKillerBonus;
+		else if (move == killers[ply][1])
+			scores[i] = secondKillerBonus;
+		else
+			scores[i] = history[us][move.from()][move.to()];
+	}
+}
+
+void Search::pickMove(MoveList& moves, int* scores, size_t index) const
+{
+	// bring the best remaining move forward, most nodes cut off after a few moves so a full sort is wasted
+
+	size_t best = index;
+
+	for (size_t i = index + 1; i < moves.size(); ++i)
+		if (scores[i] > scores[best])
+			best = i;
+
+	std::swap(moves[index], moves[best]);
+	std::swap(scores[index], scores[best]);
+}
+
+bool Search::isCapture(const Move& move) const
+{
+	return pos.pieceAt(move.to()) || (abs(pos.pieceAt(move.from())) == pawn && move.to() == pos.enPassantSquare());
+}
+
+bool Search::isRepetition() const
+{
+	// only positions with the same side to move since the last capture or pawn move can be equal
+
+	int end = int(keyStack.size());
+	int reach = pos.halfMoveClock() < end ? pos.halfMoveClock() : end;
+
+	for (int i = 2; i <= reach; i += 2)
+		if (keyStack[end - i] == pos.hash())
+			return true;
+
+	return false;
+}
+
+void Search::updatePv(const Move& move, int ply)
+{
+	pvTable[ply][ply] = move;
+
+	for (int next = ply + 1; next < pvLength[ply + 1]; ++next)
+		pvTable[ply][next] = pvTable[ply + 1][next];
+
+	pvLength[ply] = pvLength[ply + 1];
+}
+
+void Search::updateQuietStats(const Move& move, int depth, int ply)
+{
+	if (move != killers[ply][0])
+	{
+		killers[ply][1] = killers[ply][0];
+		killers[ply][0] = move;
+	}
+
+	int& score = history[pos.sideToMove()][move.from()][move.to()];
+	score += depth * depth;
+
+	if (score >= secondKillerBonus)							// keep history below the killers, halve the whole table
+		for (int c = 0; c < 2; ++c)
+			for (int from = 0; from < 64; ++from)
+				for (int to = 0; to < 64; ++to)
+					history[c][from][to] /= 2;
+}
+
+
+// Limits
+
+bool Search::shouldStop()
+{
+	// the clock is read every few thousand nodes by the main thread, the first iteration always completes
+
+	uint64_t count = nodes.load(std::memory_order_relaxed) + 1;			// only this thread writes, no atomic increment needed
+	nodes.store(count, std::memory_order_relaxed);
+
+	if ((count & 2047) == 0 && threadId == 0 && limits.moveTime > 0 && rootDepth > 1 && elapsed() >= limits.moveTime)
+		shared.stop = true;
+
+	return shared.stop.load(std::memory_order_relaxed);
+}
+
+int64_t Search::elapsed() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
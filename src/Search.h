@@ -0,0 +1,98 @@
+#pragma once
+#include "Evaluate.h"
+#include "Movegen.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Alpha-beta engine: negamax with iterative deepening and a quiescence search over captures. Moves
+// are tried in the order hash move, principal variation, captures by MVV-LVA, killer moves, history
+// score. Results are kept in a transposition table owned by the caller.
+//
+// Several Search objects can work on the same position at once (Lazy SMP): they share the table and
+// a SearchShared block, and helpers spread out over the iterations so the threads do not all search
+// the same depth. Only thread 0 watches the clock and reports progress.
+
+const int maxPly = 64;						// deepest ply the search can reach, quiescence included
+const int mateScore = 32000;				// score for mating at the root, mates further away score one less per ply
+const int infiniteScore = 32001;			// bound outside every possible score
+
+static_assert(nnueMaxScore < mateScore - maxPly, "network scores must not look like mates");
+
+struct SearchLimits
+{
+	int depth = maxPly - 1;					// deepest iteration to complete
+	int moveTime = 0;						// milliseconds to think, 0 for no time limit
+};
+
+struct SearchInfo
+{
+	int depth = 0;							// last completed iteration
+	int score = 0;							// centipawns for the side to move, within maxPly of +-mateScore for mates
+	uint64_t nodes = 0;						// positions visited, quiescence included
+	int64_t time = 0;						// milliseconds since the search started
+	uint64_t nps = 0;						// nodes per second
+	std::vector<Move> pv;					// principal variation, pv[0] is the move to play
+};
+
+struct SearchShared
+{
+	std::atomic<bool> stop{ false };						// ends every thread of the search, cleared by the caller before starting
+	std::atomic<int> threadsAtDepth[maxPly] = {};			// number of threads currently searching each iteration
+	int threadCount = 1;									// threads searching the position
+};
+
+class Search
+{
+	// Public Functions
+public:
+	// Constructor
+
+	Search(TranspositionTable& tt, SearchShared& shared, int threadId = 0);
+
+	// Searching
+
+	SearchInfo think(const Position& pos, const SearchLimits& limits, const std::vector<Key>& gameHistory = std::vector<Key>());	// keys of the game before pos, oldest first
+	void stop();															// may be called from another thread
+	void onIteration(const std::function<void(const SearchInfo&)>& callback);	// called after every completed depth
+	uint64_t getNodes() const;												// nodes of the running search, may be read from another thread
+
+	// Private Functions
+private:
+	int negamax(int alpha, int beta, int depth, int ply);
+	int quiescence(int alpha, int beta, int ply);
+
+	void scoreMoves(const MoveList& moves, int ply, const Move& hashMove, int* scores) const;
+	void pickMove(MoveList& moves, int* scores, size_t index) const;
+	bool isCapture(const Move& move) const;
+	bool isRepetition() const;
+	void updatePv(const Move& move, int ply);
+	void updateQuietStats(const Move& move, int depth, int ply);
+	bool shouldStop();
+	int64_t elapsed() const;
+
+	// Private Variables
+private:
+	TranspositionTable& tt;							// shared with other searches
+	SearchShared& shared;							// stop flag and depth counts shared with other threads
+	int threadId;									// 0 for the main thread, helpers skip crowded depths
+	Position pos;									// searched position, changed by make/unmake only
+	std::vector<Key> keyStack;						// keys of the positions before pos, the game history then the searched line
+	SearchLimits limits;							// limits of the current search
+	std::chrono::steady_clock::time_point start;	// time think() was called
+	int rootDepth;									// depth of the current iteration
+	std::atomic<uint64_t> nodes;					// positions visited in the current search, written by this thread only
+	std::function<void(const SearchInfo&)> callback;
+
+	Move killers[maxPly][2];						// quiet moves that caused a beta cutoff at each ply
+	int history[2][64][64];							// cutoff scores of quiet moves by side, from and to square
+	Move pvTable[maxPly][maxPly];					// triangular table, row ply holds the best line from that ply
+	int pvLength[maxPly];							// end of each row of pvTable
+	Move previousPv[maxPly];						// principal variation of the last iteration, searched first
+
+	MoveList moveLists[maxPly];						// one list per ply, kept here so deep searches do not grow the stack
+	int scoreLists[maxPly][maxMoves];				// ordering scores of moveLists
+};
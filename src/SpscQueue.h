@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Fixed-size lock-free queue for exactly one producer thread and one consumer thread. Neither side
+// ever waits: push() fails when the queue is full and pop() fails when it is empty. The two indices
+// sit on separate cache lines so the threads do not invalidate each other's line on every call.
+
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity && !(Capacity & (Capacity - 1)), "capacity must be a power of two");
+
+	// Public Functions
+public:
+	bool push(const T& item)									// producer thread only
+	{
+		size_t write = writeIndex.load(std::memory_order_relaxed);
+
+		if (write - readIndex.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		slots[write & (Capacity - 1)] = item;
+		writeIndex.store(write + 1, std::memory_order_release);	// publishes the slot to the consumer
+		return true;
+	}
+
+	bool pop(T& item)											// consumer thread only
+	{
+		size_t read = readIndex.load(std::memory_order_relaxed);
+
+		if (read == writeIndex.load(std::memory_order_acquire))
+			return false;
+
+		item = std::move(slots[read & (Capacity - 1)]);
+		readIndex.store(read + 1, std::memory_order_release);	// hands the slot back to the producer
+		return true;
+	}
+
+	bool empty() const											// consumer thread only
+	{
+		return readIndex.load(std::memory_order_relaxed) == writeIndex.load(std::memory_order_acquire);
+	}
+
+	// Private Variables
+private:
+	alignas(64) std::atomic<size_t> readIndex{ 0 };				// next slot to pop, written by the consumer
+	alignas(64) std::atomic<size_t> writeIndex{ 0 };			// next slot to push, written by the producer
+	T slots[Capacity];
+};
@@ -0,0 +1,58 @@
+#include "TextureRegistry.h"
+#include <iostream>			// for std::cerr
+
+struct TextureFile
+{
+	const char* name;
+	bool smooth;
+};
+
+// files in boardTextures order
+static const TextureFile textureFiles[int(boardTextures::count)] =
+{
+	{ "marble.jpg",			false },
+	{ "inverted_grey.png",	true },
+	{ "grey.png",			true },
+	{ "red.png",			true },
+};
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+TextureRegistry::TextureRegistry(const std::string& directory)
+{
+	this->directory = directory;
+}
+
+
+// Textures
+
+bool TextureRegistry::loadAll()
+{
+	bool loaded = true;
+
+	for (int i = 0; i < int(boardTextures::count); ++i)
+	{
+		std::string path = directory + textureFiles[i].name;
+
+		if (!textures[i].loadFromFile(path))
+		{
+			std::cerr << "Error! Texture " << path << " not loaded, using a blank texture! TextureRegistry::loadAll()" << std::endl;
+
+			sf::Image blank;
+			blank.create(1, 1, sf::Color::White);
+			textures[i].loadFromImage(blank);
+			loaded = false;
+		}
+
+		textures[i].setSmooth(textureFiles[i].smooth);
+	}
+
+	return loaded;
+}
+
+const sf::Texture& TextureRegistry::get(const boardTextures& texture) const
+{
+	return textures[int(texture)];
+}
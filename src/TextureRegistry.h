@@ -0,0 +1,27 @@
+#pragma once
+#include "SFML/Graphics.hpp"
+#include <string>
+
+enum class boardTextures { marble, invertedGrey, grey, red, count };
+
+// Auxiliary textures used by the board, all loaded once at startup. A texture that cannot be loaded
+// is reported and replaced by a plain white one, so drawing never has to deal with missing files.
+
+class TextureRegistry
+{
+	// Public Functions
+public:
+	// Constructor
+
+	TextureRegistry(const std::string& directory);
+
+	// Textures
+
+	bool loadAll();													// false if any texture had to be replaced
+	const sf::Texture& get(const boardTextures& texture) const;
+
+	// Private Variables
+private:
+	std::string directory;											// folder containing the texture files
+	sf::Texture textures[int(boardTextures::count)];				// indexed by boardTextures
+};
@@ -0,0 +1,146 @@
+#include "TranspositionTable.h"
+
+// data layout: move 16 bits (packed as in Move, 0 for none), score 16, depth 8, bound 2, generation 6
+
+static uint64_t pack(const Move& move, int score, int depth, Bound bound, uint8_t generation)
+{
+	return uint64_t(move.data) | uint64_t(uint16_t(int16_t(score))) << 16 | uint64_t(uint8_t(depth)) << 32 | uint64_t(bound) << 40 | uint64_t(generation & 63) << 42;
+}
+
+static TTEntry unpack(uint64_t data)
+{
+	TTEntry entry;
+	entry.move = Move::fromData(uint16_t(data));
+	entry.score = int16_t(uint16_t(data >> 16));
+	entry.depth = int(data >> 32 & 255);
+	entry.bound = Bound(data >> 40 & 3);
+	return entry;
+}
+
+static uint8_t generationOf(uint64_t data)
+{
+	return uint8_t(data >> 42 & 63);
+}
+
+// ------------------------------------------- PUBLIC FUNCTIONS -------------------------------------------
+
+// Constructor
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+	clusterCount = 0;
+	generation = 0;
+	resize(megabytes);
+}
+
+
+// Size
+
+void TranspositionTable::resize(size_t megabytes)
+{
+	size_t count = 1;
+
+	while (count * 2 * sizeof(Cluster) <= (megabytes ? megabytes : 1) << 20)
+		count *= 2;
+
+	if (count != clusterCount)
+	{
+		clusters.reset(new Cluster[count]);
+		clusterCount = count;
+	}
+
+	clear();
+}
+
+void TranspositionTable::clear()
+{
+	for (size_t i = 0; i < clusterCount; ++i)
+	{
+		for (Slot& slot : clusters[i].slots)
+		{
+			slot.check.store(0, std::memory_order_relaxed);
+			slot.data.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	generation = 0;
+}
+
+size_t TranspositionTable::sizeMB() const
+{
+	return (clusterCount * sizeof(Cluster)) >> 20;
+}
+
+
+// Entries
+
+void TranspositionTable::newSearch()
+{
+	generation = (generation + 1) & 63;
+}
+
+bool TranspositionTable::probe(Key key, TTEntry& entry) const
+{
+	const Cluster& cluster = clusters[key & (clusterCount - 1)];
+
+	for (const Slot& slot : cluster.slots)
+	{
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+
+		if (data && (slot.check.load(std::memory_order_relaxed) ^ data) == key)
+		{
+			entry = unpack(data);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TranspositionTable::store(Key key, const Move& move, int score, int depth, Bound bound)
+{
+	Cluster& cluster = clusters[key & (clusterCount - 1)];
+	Slot* victim = &cluster.slots[0];
+	int victimWorth = 1 << 30;
+	Move best = move;
+
+	for (Slot& slot : cluster.slots)
+	{
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+
+		if (!data || (slot.check.load(std::memory_order_relaxed) ^ data) == key)	// empty or same position
+		{
+			victim = &slot;
+
+			if (data && move.isNone())											// keep the known best move
+				best = unpack(data).move;
+
+			break;
+		}
+
+		int age = (generation - generationOf(data)) & 63;
+		int worth = unpack(data).depth - 8 * age;
+
+		if (worth < victimWorth)
+		{
+			victim = &slot;
+			victimWorth = worth;
+		}
+	}
+
+	uint64_t data = pack(best, score, depth, bound, generation);
+	victim->data.store(data, std::memory_order_relaxed);
+	victim->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const
+{
+	int used = 0;
+	size_t sampled = clusterCount < 250 ? clusterCount : 250;
+
+	for (size_t i = 0; i < sampled; ++i)
+		for (const Slot& slot : clusters[i].slots)
+			used += slot.data.load(std::memory_order_relaxed) && generationOf(slot.data.load(std::memory_order_relaxed)) == generation;
+
+	return int(used * 1000 / (sampled * 4));
+}
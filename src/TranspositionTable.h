@@ -0,0 +1,64 @@
+#pragma once
+#include "Move.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Shared hash table of search results. Each 64-byte cluster fills one cache line and holds four
+// entries, so a probe touches a single line. Entries are written without locks: the key is stored
+// xored with the data, and a read whose two halves come from different writes fails the key check
+// and is treated as a miss. Several search threads may probe and store at the same time.
+//
+// Replacement: an entry for the same position is always overwritten. Otherwise the entry replaced
+// is the one worth least, with depth counting for it and each search it is older counting against it.
+
+enum Bound { noBound, upperBound, lowerBound, exactBound };
+
+struct TTEntry
+{
+	Move move;						// best or refuting move, Move() if none
+	int score;						// search score as stored, mates relative to the stored position
+	int depth;						// remaining depth the score was searched to
+	Bound bound;					// whether score is exact or a bound on the true score
+};
+
+class TranspositionTable
+{
+	// Public Functions
+public:
+	// Constructor
+
+	TranspositionTable(size_t megabytes = 16);
+
+	// Size
+
+	void resize(size_t megabytes);						// rounded down to a power of two clusters, clears the table
+	void clear();
+	size_t sizeMB() const;
+
+	// Entries
+
+	void newSearch();									// entries of earlier searches become the first to be replaced
+	bool probe(Key key, TTEntry& entry) const;
+	void store(Key key, const Move& move, int score, int depth, Bound bound);
+	int hashfull() const;								// permille of sampled entries written in the current search
+
+	// Private Types
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> check;					// key xor data
+		std::atomic<uint64_t> data;						// packed TTEntry and generation, 0 if empty
+	};
+
+	struct alignas(64) Cluster
+	{
+		Slot slots[4];
+	};
+
+	// Private Variables
+private:
+	std::unique_ptr<Cluster[]> clusters;
+	size_t clusterCount;								// power of two, so a key is reduced with a mask
+	uint8_t generation;									// counts searches, 6 bits are stored with each entry
+};
@@ -0,0 +1,42 @@
+#include "Zobrist.h"
+
+Key pieceKeys[13][64];
+Key castlingKeys[16];
+Key enPassantKeys[8];
+Key sideKey;
+
+static Key randomKey(uint64_t& seed)
+{
+	seed ^= seed >> 12;															// xorshift64*
+	seed ^= seed << 25;
+	seed ^= seed >> 27;
+	return seed * 2685821657736338717ULL;
+}
+
+void initZobrist()
+{
+	uint64_t seed = 1070372;													// fixed seed, hashes are the same in every run
+
+	for (int piece = 0; piece < 13; ++piece)
+		for (int s = 0; s < 64; ++s)
+			pieceKeys[piece][s] = piece == 6 ? 0 : randomKey(seed);				// empty squares do not change the hash
+
+	Key rightKeys[4];
+
+	for (int k = 0; k < 4; ++k)
+		rightKeys[k] = randomKey(seed);
+
+	for (int rights = 0; rights < 16; ++rights)									// one key per right, combined for each set of rights
+	{
+		castlingKeys[rights] = 0;
+
+		for (int k = 0; k < 4; ++k)
+			if (rights & (1 << k))
+				castlingKeys[rights] ^= rightKeys[k];
+	}
+
+	for (int file = 0; file < 8; ++file)
+		enPassantKeys[file] = randomKey(seed);
+
+	sideKey = randomKey(seed);
+}
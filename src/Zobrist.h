@@ -0,0 +1,16 @@
+#pragma once
+#include "Bitboard.h"
+
+// Random keys xored together into a 64-bit hash of a position. Position keeps its hash up to date
+// with every piece it puts, removes or moves, so it never has to be computed from scratch.
+
+typedef uint64_t Key;
+
+extern Key pieceKeys[13][64];					// indexed by signed piece code + 6 and square
+extern Key castlingKeys[16];					// indexed by CastlingRights flags, no rights hash to 0
+extern Key enPassantKeys[8];					// indexed by file of the en passant target square
+extern Key sideKey;								// included when black is to move
+
+void initZobrist();								// called by initBitboards()
+
+inline Key pieceKey(int piece, Square s)		{ return pieceKeys[piece + 6][s]; }
@@ -3,85 +3,118 @@
 const float viewLength = 512.0f;
 const unsigned int windowLength = 984;
 sf::Color backgroundColor = sf::Color(20, 20, 20, 0);
+const bool onDemandRendering = true;		// redraw only when something changed instead of every frame
 
-int main()
+// returns true if the event may change what is on screen
+bool handleEvent(const sf::Event& e, sf::RenderWindow& window, sf::View& view, Board& chessBoard)
 {
-	//sf::RenderWindow window(sf::VideoMode(windowLength, windowLength), "Chess | C++ | SFML", sf::Style::Default);
-	sf::RenderWindow window(sf::VideoMode::getDesktopMode(), "Chess | C++ | SFML", sf::Style::Fullscreen);
-	window.setFramerateLimit(60);
-	window.setKeyRepeatEnabled(false);
+	if (e.type == sf::Event::Closed)
+		window.close();
 
-	sf::View view(sf::Vector2f(viewLength / 2, viewLength / 2), sf::Vector2f(viewLength, viewLength));
 
-	Board chessBoard(boardThemes::random, "pixel");
-	chessBoard.resize(view, viewLength, window.getSize());
+	if (e.type == sf::Event::Resized)
+		chessBoard.resize(view, viewLength, window.getSize());
 
-	sf::Event e;
-	sf::Vector2i mousePos;
 
-	while (window.isOpen())
+	if (e.type == sf::Event::KeyPressed)
 	{
-		while (window.pollEvent(e))
-		{
-
-			if (e.type == sf::Event::Closed)
-				window.close();
+		if (e.key.code == sf::Keyboard::Q || e.key.code == sf::Keyboard::Escape)
+			window.close();
 
+		if (e.key.code == sf::Keyboard::F)
+			chessBoard.flip();
 
-			if (e.type == sf::Event::Resized)
-				chessBoard.resize(view, viewLength, window.getSize());
+		if (e.key.code == sf::Keyboard::B)
+			chessBoard.randomBoardTheme();
 
+		if (e.key.code == sf::Keyboard::R)
+			chessBoard.rgbBoardTheme();
 
-			if (e.type == sf::Event::KeyPressed)
-			{
-				if (e.key.code == sf::Keyboard::Q || e.key.code == sf::Keyboard::Escape)
-					window.close();
+		if (e.key.code == sf::Keyboard::P)
+			chessBoard.randomPieceTheme();
 
-				if (e.key.code == sf::Keyboard::F)
-					chessBoard.flip();
+		if (e.key.code == sf::Keyboard::H)
+			chessBoard.togglePieceVisibilty();
 
-				if (e.key.code == sf::Keyboard::B)
-					chessBoard.randomBoardTheme();
+		if (e.key.code == sf::Keyboard::L)
+			chessBoard.toggleLabelsVisibility();
 
-				if (e.key.code == sf::Keyboard::R)
-					chessBoard.rgbBoardTheme();
+		if (e.key.code == sf::Keyboard::T)
+			chessBoard.toggleThreatsVisibility();
 
-				if (e.key.code == sf::Keyboard::P)
-					chessBoard.randomPieceTheme();
+		if (e.key.code == sf::Keyboard::N)
+			chessBoard.toggleNotationVisibility();
 
-				if (e.key.code == sf::Keyboard::H)
-					chessBoard.togglePieceVisibilty();
+		if (e.key.code == sf::Keyboard::A)
+			chessBoard.toggleNotationAlignment();
 
-				if (e.key.code == sf::Keyboard::L)
-					chessBoard.toggleLabelsVisibility();
+		if (e.key.code == sf::Keyboard::E)
+			chessBoard.toggleEngine();
 
-				if (e.key.code == sf::Keyboard::T)
-					chessBoard.toggleThreatsVisibility();
+		if (e.key.code == sf::Keyboard::Left)
+			chessBoard.undoMove();
 
-				if (e.key.code == sf::Keyboard::N)
-					chessBoard.toggleNotationVisibility();
+		if (e.key.code == sf::Keyboard::Right)
+			chessBoard.redoMove();
 
-				if (e.key.code == sf::Keyboard::A)
-					chessBoard.toggleNotationAlignment();
-			}
+		if (e.key.code == sf::Keyboard::S)
+			chessBoard.saveGame();
 
+		if (e.key.code == sf::Keyboard::O)
+			chessBoard.openGame();
+	}
 
-			if (e.type == sf::Event::MouseButtonPressed || e.type == sf::Event::MouseButtonReleased)
-			{
-				if (e.mouseButton.button == sf::Mouse::Left)
-				{
-					mousePos = sf::Mouse::getPosition(window);
-					chessBoard.movePiece(mousePos, window.getSize(), sf::Mouse::isButtonPressed(sf::Mouse::Left));
-				}
-			}
 
+	if (e.type == sf::Event::MouseButtonPressed || e.type == sf::Event::MouseButtonReleased)
+	{
+		if (e.mouseButton.button == sf::Mouse::Left)
+		{
+			sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+			chessBoard.movePiece(mousePos, window.getSize(), sf::Mouse::isButtonPressed(sf::Mouse::Left));
 		}
+	}
+
+	// window contents may be lost while the window is hidden or resized
+	return e.type == sf::Event::Resized || e.type == sf::Event::GainedFocus;
+}
+
+int main()
+{
+	//sf::RenderWindow window(sf::VideoMode(windowLength, windowLength), "Chess | C++ | SFML", sf::Style::Default);
+	sf::RenderWindow window(sf::VideoMode::getDesktopMode(), "Chess | C++ | SFML", sf::Style::Fullscreen);
+	window.setFramerateLimit(60);
+	window.setKeyRepeatEnabled(false);
+
+	sf::View view(sf::Vector2f(viewLength / 2, viewLength / 2), sf::Vector2f(viewLength, viewLength));
+
+	Board chessBoard(boardThemes::random, "pixel");
+	chessBoard.resize(view, viewLength, window.getSize());
 
-		window.clear(backgroundColor);
-		window.setView(view);
-		chessBoard.draw(window);
-		window.display();
+	sf::Event e;
+	bool redraw = true;			// the first frame is always drawn
+
+	while (window.isOpen())
+	{
+		if (onDemandRendering && !redraw && !chessBoard.isAnimating() && window.waitEvent(e))	// sleep until there is input, once a frame is up
+			redraw |= handleEvent(e, window, view, chessBoard);
+
+		while (window.pollEvent(e))
+			redraw |= handleEvent(e, window, view, chessBoard);
+
+		if (!window.isOpen())
+			break;
+
+		if (chessBoard.needsRedraw() || redraw || !onDemandRendering)
+		{
+			window.clear(backgroundColor);
+			window.setView(view);
+			chessBoard.draw(window);
+			window.display();
+			redraw = false;
+		}
+		else
+			sf::sleep(sf::milliseconds(5));			// animating, but the next color step is not due yet
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,355 @@
+#include "../Engine.h"
+#include "../San.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Runs a test suite of EPD positions (WAC, STS and the like) through the engine and reports how
+// many it solves and how fast. A position is solved when the engine settles on a best move (bm) or
+// avoids every move to avoid (am). Each worker thread owns a single-threaded Engine and a queue of
+// positions, and steals from the back of another queue once its own runs dry, so a few slow
+// positions do not leave the other cores idle.
+//
+//   epd-bench <file> [threads] [time <ms> | depth <plies>] [hash <MB>]		exit code 1 if a position could not be read
+
+struct EpdPosition
+{
+	std::string id;								// id operation, or the line number
+	std::string fen;							// the first four fields
+	Position pos;
+	std::vector<Move> bestMoves;				// bm, any of them solves the position
+	std::vector<Move> avoidMoves;				// am, all of them must be avoided
+	std::string expected;						// bm and am moves in SAN, for the report
+};
+
+struct EpdResult
+{
+	bool solved = false;
+	Move move;									// move the engine chose
+	int depth = 0;
+	int score = 0;
+	uint64_t nodes = 0;
+	int64_t time = 0;							// milliseconds
+	int64_t solvedAt = -1;						// milliseconds until the engine found and kept a solving move, -1 if never
+};
+
+// Reading
+
+std::vector<std::string_view> splitOperands(std::string_view text)
+{
+	std::vector<std::string_view> operands;
+	size_t p = 0;
+
+	while ((p = text.find_first_not_of(" \t", p)) != std::string_view::npos)
+	{
+		size_t end = std::min(text.find_first_of(" \t", p), text.size());
+		operands.push_back(text.substr(p, end - p));
+		p = end;
+	}
+
+	return operands;
+}
+
+bool readEpd(std::string_view line, int lineNumber, EpdPosition& epd, std::string& error)
+{
+	// four FEN fields, then operations "opcode operand ...;" where string operands may hold a ';'
+
+	size_t p = 0;
+
+	for (int field = 0; field < 4 && p != std::string_view::npos; ++field)
+	{
+		p = line.find_first_not_of(" \t", p);
+		p = p == std::string_view::npos ? p : line.find_first_of(" \t", p);
+	}
+
+	epd.fen = std::string(line.substr(0, p));
+	epd.id = "line " + std::to_string(lineNumber);
+
+	FenError fenError = epd.pos.loadFen(epd.fen);
+
+	if (fenError != fenOk)
+	{
+		error = std::string("invalid position, ") + fenErrorText(fenError);
+		return false;
+	}
+
+	std::string_view ops = p == std::string_view::npos ? std::string_view() : line.substr(p);
+
+	while (!ops.empty())
+	{
+		size_t end = 0;
+		bool quoted = false;
+
+		while (end < ops.size() && (quoted || ops[end] != ';'))
+			quoted ^= ops[end++] == '"';
+
+		std::vector<std::string_view> operands = splitOperands(ops.substr(0, end));
+		ops.remove_prefix(end < ops.size() ? end + 1 : end);
+
+		if (operands.empty())
+			continue;
+
+		std::string_view opcode = operands[0];
+
+		if (opcode == "id" && operands.size() > 1)					// the string may contain spaces
+		{
+			std::string_view last = operands.back();
+			epd.id = std::string(operands[1].data(), last.data() + last.size() - operands[1].data());
+			epd.id.erase(std::remove(epd.id.begin(), epd.id.end(), '"'), epd.id.end());
+			continue;
+		}
+
+		if (opcode != "bm" && opcode != "am")
+			continue;
+
+		epd.expected += (epd.expected.empty() ? "" : " ") + std::string(opcode);
+
+		for (size_t i = 1; i < operands.size(); ++i)
+		{
+			Move move = sanToMove(epd.pos, operands[i]);
+
+			if (move.isNone())
+			{
+				error = "illegal move " + std::string(operands[i]);
+				return false;
+			}
+
+			(opcode == "bm" ? epd.bestMoves : epd.avoidMoves).push_back(move);
+			epd.expected += " " + moveToSan(epd.pos, move);
+		}
+	}
+
+	if (epd.bestMoves.empty() && epd.avoidMoves.empty())
+	{
+		error = "no bm or am operation";
+		return false;
+	}
+
+	return true;
+}
+
+// Work Stealing
+
+struct WorkQueue
+{
+	std::mutex mutex;
+	std::deque<size_t> positions;				// indexes into the suite, the owner takes from the front
+};
+
+bool takeWork(std::vector<WorkQueue>& queues, size_t self, size_t& index)
+{
+	{
+		std::lock_guard<std::mutex> lock(queues[self].mutex);
+
+		if (!queues[self].positions.empty())
+		{
+			index = queues[self].positions.front();
+			queues[self].positions.pop_front();
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i < queues.size(); ++i)	// steal from the back, away from where the owner works
+	{
+		WorkQueue& victim = queues[(self + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if (!victim.positions.empty())
+		{
+			index = victim.positions.back();
+			victim.positions.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Solving
+
+bool solves(const EpdPosition& epd, const Move& move)
+{
+	auto matches = [&move](const Move& other) { return other.sameAs(move); };
+
+	if (!epd.bestMoves.empty() && std::none_of(epd.bestMoves.begin(), epd.bestMoves.end(), matches))
+		return false;
+
+	return std::none_of(epd.avoidMoves.begin(), epd.avoidMoves.end(), matches);
+}
+
+void work(const std::vector<EpdPosition>& suite, std::vector<EpdResult>& results, std::vector<WorkQueue>& queues, size_t self, SearchLimits limits, size_t hashMB)
+{
+	Engine engine(1, hashMB);
+	const EpdPosition* epd = nullptr;
+	EpdResult* result = nullptr;
+
+	engine.onIteration([&epd, &result](const SearchInfo& info)		// remember when the engine last switched to a solving move
+	{
+		bool solving = !info.pv.empty() && solves(*epd, info.pv[0]);
+
+		if (!solving)
+			result->solvedAt = -1;
+		else if (result->solvedAt < 0)
+			result->solvedAt = info.time;
+	});
+
+	size_t index;
+
+	while (takeWork(queues, self, index))
+	{
+		epd = &suite[index];
+		result = &results[index];
+
+		engine.clearHash();										// every position is searched the same way whatever ran before
+		engine.start(epd->pos, limits);
+		engine.wait();
+
+		SearchInfo info = engine.getResult();
+		result->move = info.pv.empty() ? Move() : info.pv[0];
+		result->solved = !info.pv.empty() && solves(*epd, info.pv[0]);
+		result->depth = info.depth;
+		result->score = info.score;
+		result->nodes = info.nodes;
+		result->time = info.time;
+
+		if (!result->solved)
+			result->solvedAt = -1;
+		else if (result->solvedAt < 0)							// solved by a move no completed iteration reported, e.g. after a stop
+			result->solvedAt = info.time;
+	}
+}
+
+// Report
+
+void printResults(const std::vector<EpdPosition>& suite, const std::vector<EpdResult>& results, double seconds)
+{
+	int solved = 0;
+	uint64_t nodes = 0;
+	int64_t searchTime = 0, solveTime = 0;
+
+	std::cout << std::left << std::setw(16) << "Id" << std::setw(8) << "Result" << std::setw(10) << "Move" << std::setw(24) << "Expected"
+		<< std::right << std::setw(6) << "Depth" << std::setw(8) << "Score" << std::setw(12) << "Nodes" << std::setw(10) << "NPS" << std::setw(10) << "Solved at" << std::endl;
+
+	for (size_t i = 0; i < suite.size(); ++i)
+	{
+		const EpdResult& r = results[i];
+		solved += r.solved;
+		nodes += r.nodes;
+		searchTime += r.time;
+		solveTime += r.solved ? r.solvedAt : 0;
+
+		std::cout << std::left << std::setw(15) << suite[i].id << " " << std::setw(8) << (r.solved ? "ok" : "FAIL")
+			<< std::setw(10) << (r.move.isNone() ? std::string("-") : moveToSan(suite[i].pos, r.move)) << std::setw(24) << suite[i].expected
+			<< std::right << std::setw(6) << r.depth << std::setw(8) << r.score << std::setw(12) << r.nodes
+			<< std::setw(10) << r.nodes * 1000 / (r.time > 0 ? r.time : 1)
+			<< std::setw(10) << (r.solved ? std::to_string(r.solvedAt) + " ms" : std::string("-")) << std::endl;
+	}
+
+	std::cout.setf(std::ios::fixed);
+	std::cout.precision(1);
+
+	std::cout << "Solved: " << solved << " / " << suite.size() << " (" << (suite.empty() ? 0.0 : 100.0 * solved / suite.size()) << "%)"
+		<< "\tAverage time to solution: " << (solved ? double(solveTime) / solved : 0.0) << " ms" << std::endl;
+	std::cout << "Nodes: " << nodes << "\tNPS per thread: " << nodes * 1000 / uint64_t(searchTime > 0 ? searchTime : 1)
+		<< "\tTime: " << seconds << " s" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: epd-bench <file> [threads] [time <ms> | depth <plies>] [hash <MB>]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ifstream file(argv[1]);
+
+	if (!file)
+	{
+		std::cerr << "Error! " << argv[1] << " not found!" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	int threads = int(std::thread::hardware_concurrency());
+	SearchLimits limits;
+	limits.moveTime = 1000;
+	size_t hashMB = 16;
+
+	for (int i = 2; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "time" && i + 1 < argc)
+			limits.moveTime = std::atoi(argv[++i]);
+		else if (arg == "depth" && i + 1 < argc)
+		{
+			limits.depth = std::max(1, std::min(std::atoi(argv[++i]), maxPly - 1));
+			limits.moveTime = 0;
+		}
+		else if (arg == "hash" && i + 1 < argc)
+			hashMB = size_t(std::max(1, std::atoi(argv[++i])));
+		else
+			threads = std::atoi(arg.c_str());
+	}
+
+	threads = threads > 0 ? threads : 1;
+
+	// Read the suite
+
+	std::vector<EpdPosition> suite;
+	std::string line;
+	int lineNumber = 0;
+	bool readErrors = false;
+
+	while (std::getline(file, line))
+	{
+		++lineNumber;
+
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		if (line.find_first_not_of(" \t") == std::string::npos || line[line.find_first_not_of(" \t")] == '#')
+			continue;
+
+		EpdPosition epd;
+		std::string error;
+
+		if (!readEpd(line, lineNumber, epd, error))
+		{
+			std::cerr << "Error! " << error << " on line " << lineNumber << ", position skipped!" << std::endl;
+			readErrors = true;
+			continue;
+		}
+
+		suite.push_back(std::move(epd));
+	}
+
+	// Solve it, positions dealt round-robin so every queue holds a share of easy and hard ones
+
+	std::vector<EpdResult> results(suite.size());
+	std::vector<WorkQueue> queues(threads);
+
+	for (size_t i = 0; i < suite.size(); ++i)
+		queues[i % queues.size()].positions.push_back(i);
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+
+	for (int i = 0; i < threads; ++i)
+		workers.emplace_back(work, std::cref(suite), std::ref(results), std::ref(queues), size_t(i), limits, hashMB);
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	printResults(suite, results, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	return readErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
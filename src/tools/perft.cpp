@@ -0,0 +1,150 @@
+#include "../Movegen.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Counts leaf nodes of the legal move tree to verify the rules engine and measure its speed.
+//
+//   perft <depth> [fen]			total nodes and nodes/second
+//   perft divide <depth> [fen]		nodes below each root move
+//   perft suite					standard positions with known counts, exit code 1 on any mismatch
+
+struct PerftCase
+{
+	const char* name;
+	const char* fen;
+	int depth;
+	uint64_t nodes;
+};
+
+// reference counts from https://www.chessprogramming.org/Perft_Results
+const PerftCase suite[] =
+{
+	{ "startpos",	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",					5,	4865609 },
+	{ "kiwipete",	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",		4,	4085603 },
+	{ "position 3",	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",								6,	11030083 },
+	{ "position 4",	"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",			5,	15833292 },
+	{ "mirrored 4",	"r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",			5,	15833292 },
+	{ "position 5",	"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",				4,	2103487 },
+	{ "position 6",	"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",	4,	3894594 },
+};
+
+uint64_t perft(Position& pos, int depth)
+{
+	MoveList moves;
+	generateLegalMoves(pos, moves);
+
+	if (depth <= 1)								// bulk count the last ply
+		return depth == 1 ? moves.size() : 1;
+
+	uint64_t nodes = 0;
+	UndoInfo undo;
+
+	for (const Move& move : moves)
+	{
+		pos.makeMove(move, undo);
+		nodes += perft(pos, depth - 1);
+		pos.unmakeMove(move, undo);
+	}
+
+	return nodes;
+}
+
+double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printSpeed(uint64_t nodes, double seconds)
+{
+	std::cout << "Nodes: " << nodes << "\tTime: " << seconds << " s\tNPS: " << uint64_t(nodes / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+}
+
+int runSuite()
+{
+	int failures = 0;
+	uint64_t totalNodes = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (const PerftCase& test : suite)
+	{
+		Position pos;
+		pos.loadFen(test.fen);
+
+		uint64_t nodes = perft(pos, test.depth);
+		totalNodes += nodes;
+
+		bool passed = nodes == test.nodes;
+		failures += !passed;
+
+		std::cout << (passed ? "ok    " : "FAIL  ") << test.name << "\tdepth " << test.depth << "\t" << nodes;
+
+		if (!passed)
+			std::cout << " (expected " << test.nodes << ")";
+
+		std::cout << std::endl;
+	}
+
+	printSpeed(totalNodes, secondsSince(start));
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && !strcmp(argv[1], "suite"))
+		return runSuite();
+
+	bool divide = argc > 1 && !strcmp(argv[1], "divide");
+	int arg = divide ? 2 : 1;
+
+	if (argc <= arg)
+	{
+		std::cerr << "Usage: perft [divide] <depth> [fen] | perft suite" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	int depth = std::atoi(argv[arg]);
+	std::string fen = argc > arg + 1 ? argv[arg + 1] : startFen;
+
+	for (int i = arg + 2; i < argc; ++i)		// accept an unquoted FEN split over several arguments
+		fen += std::string(" ") + argv[i];
+
+	Position pos;
+
+	FenError error = pos.loadFen(fen);
+
+	if (error != fenOk)
+	{
+		std::cerr << "Error! Invalid FEN, " << fenErrorText(error) << "!" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	uint64_t nodes = 0;
+
+	if (divide && depth > 0)
+	{
+		MoveList moves;
+		generateLegalMoves(pos, moves);
+		UndoInfo undo;
+
+		for (const Move& move : moves)
+		{
+			pos.makeMove(move, undo);
+			uint64_t count = perft(pos, depth - 1);
+			pos.unmakeMove(move, undo);
+
+			std::cout << moveToCoordinate(move) << ": " << count << std::endl;
+			nodes += count;
+		}
+
+		std::cout << std::endl;
+	}
+	else
+		nodes = perft(pos, depth);
+
+	printSpeed(nodes, secondsSince(start));
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,285 @@
+#include "../Pgn.h"
+#include "../San.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Validates and summarizes a PGN database. The file is cut into chunks of whole games by one reader
+// thread and replayed through the rules by a pool of workers, each keeping its own totals that are
+// merged at the end, so throughput grows with the number of cores.
+//
+//   pgn-stats <file> [threads] [opening plies]		exit code 1 if any game has an illegal move
+
+const size_t chunkSize = 4 << 20;			// bytes handed to a worker at a time
+const size_t maxErrorsShown = 10;
+
+struct Stats
+{
+	uint64_t games = 0;
+	uint64_t illegalGames = 0;
+	uint64_t plies = 0;
+	uint64_t results[4] = {};								// 1-0, 0-1, 1/2-1/2, *
+	std::unordered_map<std::string, uint64_t> openings;		// first moves in SAN of games from the initial position
+	std::vector<std::string> errors;						// first few illegal games
+
+	void merge(const Stats& other)
+	{
+		games += other.games;
+		illegalGames += other.illegalGames;
+		plies += other.plies;
+
+		for (int i = 0; i < 4; ++i)
+			results[i] += other.results[i];
+
+		for (const auto& opening : other.openings)
+			openings[opening.first] += opening.second;
+
+		for (const std::string& error : other.errors)
+			if (errors.size() < maxErrorsShown)
+				errors.push_back(error);
+	}
+};
+
+// Work Queue
+
+std::mutex queueMutex;
+std::condition_variable queueChanged;
+std::deque<std::string> chunks;
+bool readingDone = false;
+
+void pushChunk(std::string&& chunk, size_t maxQueued)
+{
+	std::unique_lock<std::mutex> lock(queueMutex);
+	queueChanged.wait(lock, [maxQueued]() { return chunks.size() < maxQueued; });	// the reader must not run ahead of the workers
+	chunks.push_back(std::move(chunk));
+	queueChanged.notify_all();
+}
+
+bool popChunk(std::string& chunk)
+{
+	std::unique_lock<std::mutex> lock(queueMutex);
+	queueChanged.wait(lock, []() { return !chunks.empty() || readingDone; });
+
+	if (chunks.empty())
+		return false;
+
+	chunk = std::move(chunks.front());
+	chunks.pop_front();
+	queueChanged.notify_all();
+	return true;
+}
+
+// Splitting
+
+size_t lastGameStart(const std::string& text)
+{
+	// a tag at the start of a line whose previous non-empty line is movetext begins a new game
+
+	for (size_t p = text.size(); p-- > 1;)
+	{
+		if (text[p] != '[' || text[p - 1] != '\n')
+			continue;
+
+		size_t end = p - 1;
+
+		while (end > 0 && (text[end - 1] == '\n' || text[end - 1] == '\r'))
+			--end;
+
+		size_t start = text.rfind('\n', end > 0 ? end - 1 : 0);
+		start = start == std::string::npos ? 0 : start + 1;
+
+		if (end > 0 && text[start] != '[')
+			return p;
+	}
+
+	return std::string::npos;
+}
+
+void readChunks(std::ifstream& file, size_t maxQueued)
+{
+	std::string pending;
+	std::vector<char> block(chunkSize);
+
+	while (file.read(block.data(), std::streamsize(block.size())) || file.gcount() > 0)
+	{
+		pending.append(block.data(), size_t(file.gcount()));
+		size_t split = lastGameStart(pending);
+
+		if (split == std::string::npos)						// a single game longer than a chunk, keep reading
+			continue;
+
+		std::string rest = pending.substr(split);
+		pending.resize(split);
+		pushChunk(std::move(pending), maxQueued);
+		pending = std::move(rest);
+	}
+
+	if (!pending.empty())
+		pushChunk(std::move(pending), maxQueued);
+
+	std::lock_guard<std::mutex> lock(queueMutex);
+	readingDone = true;
+	queueChanged.notify_all();
+}
+
+// Workers
+
+void addGame(Stats& stats, const PgnGame& game, const Position& start, int openingPlies)
+{
+	++stats.games;
+	stats.plies += game.moves.size();
+
+	const char* results[4] = { "1-0", "0-1", "1/2-1/2", "*" };
+
+	for (int i = 0; i < 4; ++i)
+		if (game.result == results[i])
+			++stats.results[i];
+
+	if (!game.error.empty())
+	{
+		++stats.illegalGames;
+
+		if (stats.errors.size() < maxErrorsShown)
+		{
+			const std::string* white = game.tag("White");
+			const std::string* black = game.tag("Black");
+			stats.errors.push_back((white ? *white : "?") + " - " + (black ? *black : "?") + ": " + game.error);
+		}
+	}
+
+	if (game.startFen != startFen || game.moves.size() < size_t(openingPlies))
+		return;
+
+	Position pos = start;
+	std::string opening;
+	UndoInfo undo;
+
+	for (int i = 0; i < openingPlies; ++i)
+	{
+		opening += (i ? " " : "") + moveToSan(pos, game.moves[i]);
+		pos.makeMove(game.moves[i], undo);
+	}
+
+	++stats.openings[opening];
+}
+
+void work(Stats& stats, int openingPlies)
+{
+	PgnReader reader(1);									// reads from memory, the file buffer is never used
+	PgnGame game;
+	Position start;
+	start.loadFen(startFen);
+	std::string chunk;
+
+	while (popChunk(chunk))
+	{
+		reader.open(chunk.data(), chunk.size());
+
+		while (reader.readGame(game))
+			addGame(stats, game, start, openingPlies);
+	}
+}
+
+// Report
+
+void printPercent(const char* label, uint64_t count, uint64_t total)
+{
+	std::cout << label << count << " (" << (total ? 100.0 * count / total : 0.0) << "%)";
+}
+
+void printStats(const Stats& stats, double seconds, uint64_t bytes)
+{
+	std::cout.setf(std::ios::fixed);
+	std::cout.precision(1);
+
+	std::cout << "Games: " << stats.games << "\t";
+	printPercent("Illegal: ", stats.illegalGames, stats.games);
+	std::cout << std::endl;
+
+	printPercent("1-0: ", stats.results[0], stats.games);
+	printPercent("\t0-1: ", stats.results[1], stats.games);
+	printPercent("\t1/2-1/2: ", stats.results[2], stats.games);
+	printPercent("\t*: ", stats.results[3], stats.games);
+	std::cout << std::endl;
+
+	std::cout << "Average length: " << (stats.games ? double(stats.plies) / stats.games : 0.0) << " plies" << std::endl;
+
+	for (const std::string& error : stats.errors)
+		std::cout << "Illegal: " << error << std::endl;
+
+	std::vector<std::pair<uint64_t, std::string>> openings;
+
+	for (const auto& opening : stats.openings)
+		openings.push_back({ opening.second, opening.first });
+
+	size_t shown = std::min<size_t>(openings.size(), 10);
+	std::partial_sort(openings.begin(), openings.begin() + shown, openings.end(), std::greater<std::pair<uint64_t, std::string>>());
+
+	if (shown)
+		std::cout << "Most played openings:" << std::endl;
+
+	for (size_t i = 0; i < shown; ++i)
+	{
+		std::cout << "  ";
+		printPercent("", openings[i].first, stats.games);
+		std::cout << "\t" << openings[i].second << std::endl;
+	}
+
+	std::cout << "Time: " << seconds << " s\tGames/s: " << uint64_t(stats.games / (seconds > 0 ? seconds : 1e-9))
+		<< "\tMB/s: " << bytes / 1e6 / (seconds > 0 ? seconds : 1e-9) << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: pgn-stats <file> [threads] [opening plies]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+
+	if (!file)
+	{
+		std::cerr << "Error! " << argv[1] << " not found!" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	int threads = argc > 2 ? std::atoi(argv[2]) : int(std::thread::hardware_concurrency());
+	int openingPlies = argc > 3 ? std::atoi(argv[3]) : 4;
+	threads = threads > 0 ? threads : 1;
+
+	Position warmup;										// builds the attack tables before the workers start
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<Stats> stats(threads);
+	std::vector<std::thread> workers;
+
+	for (int i = 0; i < threads; ++i)
+		workers.emplace_back(work, std::ref(stats[i]), openingPlies);
+
+	readChunks(file, size_t(threads) * 2);
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	Stats total;
+
+	for (const Stats& s : stats)
+		total.merge(s);
+
+	file.clear();
+	uint64_t bytes = uint64_t(file.seekg(0, std::ios::end).tellg());
+
+	printStats(total, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), bytes);
+	return total.illegalGames ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+#include "../Engine.h"
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+// Universal Chess Interface front end for the engine, so it can be used from any chess GUI or
+// tournament manager. Reads commands from stdin and answers on stdout:
+//
+//   uci, isready, ucinewgame, quit
+//   setoption name Hash value <MB> | setoption name Threads value <count>
+//   setoption name EvalFile value <network file, <empty> for the classical evaluation>
+//   position startpos | fen <fen> [moves <move> ...]
+//   go [depth <n>] [movetime <ms>] [wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>] [movestogo <n>] [infinite]
+//   stop
+
+std::mutex outputMutex;		// info lines come from the search thread, everything else from the input thread
+
+void send(const std::string& line)
+{
+	std::lock_guard<std::mutex> lock(outputMutex);
+	std::cout << line << std::endl;
+}
+
+std::string scoreToUci(int score)
+{
+	if (score >= mateScore - maxPly)
+		return "mate " + std::to_string((mateScore - score + 1) / 2);
+
+	if (score <= -mateScore + maxPly)
+		return "mate -" + std::to_string((mateScore + score) / 2);
+
+	return "cp " + std::to_string(score);
+}
+
+std::string infoToUci(const SearchInfo& info, int hashfull)
+{
+	std::string line = "info depth " + std::to_string(info.depth) + " score " + scoreToUci(info.score) + " nodes " + std::to_string(info.nodes)
+		+ " nps " + std::to_string(info.nps) + " time " + std::to_string(info.time) + " hashfull " + std::to_string(hashfull) + " pv";
+
+	for (const Move& move : info.pv)
+		line += " " + moveToCoordinate(move);
+
+	return line;
+}
+
+bool playCoordinateMove(Position& pos, const std::string& str)
+{
+	MoveList moves;
+	generateLegalMoves(pos, moves);
+
+	for (const Move& move : moves)
+	{
+		if (moveToCoordinate(move) == str)
+		{
+			UndoInfo undo;
+			pos.makeMove(move, undo);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void setPosition(Position& pos, std::vector<Key>& history, std::istringstream& iss)
+{
+	std::string token, fen;
+	iss >> token;
+
+	if (token == "startpos")
+	{
+		fen = startFen;
+		iss >> token;												// "moves" if any follow
+	}
+	else if (token == "fen")
+	{
+		while (iss >> token && token != "moves")
+			fen += token + " ";
+	}
+	else
+		return;
+
+	FenError error = pos.loadFen(fen);
+
+	if (error != fenOk)
+	{
+		send(std::string("info string invalid fen, ") + fenErrorText(error));
+		return;
+	}
+
+	history.clear();
+
+	while (iss >> token)
+	{
+		Key before = pos.hash();
+
+		if (!playCoordinateMove(pos, token))
+		{
+			send("info string illegal move " + token);
+			return;
+		}
+
+		history.push_back(before);								// the search needs the game to see repetitions
+	}
+}
+
+SearchLimits parseGo(const Position& pos, std::istringstream& iss, bool& infinite)
+{
+	SearchLimits limits;
+	std::string token;
+	int time[2] = { 0, 0 }, increment[2] = { 0, 0 }, movesToGo = 0;
+	infinite = false;
+
+	while (iss >> token)
+	{
+		if (token == "depth")			iss >> limits.depth;
+		else if (token == "movetime")	iss >> limits.moveTime;
+		else if (token == "wtime")		iss >> time[white];
+		else if (token == "btime")		iss >> time[black];
+		else if (token == "winc")		iss >> increment[white];
+		else if (token == "binc")		iss >> increment[black];
+		else if (token == "movestogo")	iss >> movesToGo;
+		else if (token == "infinite")	infinite = true;
+	}
+
+	Color us = pos.sideToMove();
+
+	if (!limits.moveTime && time[us] > 0 && !infinite)				// spread the clock over the moves left, keep a safety margin
+	{
+		int budget = time[us] / (movesToGo > 0 ? movesToGo : 30) + increment[us] / 2;
+		int available = time[us] - 50 > 1 ? time[us] - 50 : 1;
+		limits.moveTime = budget < available ? budget : available;
+	}
+
+	return limits;
+}
+
+int main()
+{
+	Engine engine(1, 16);
+	Position pos;
+	pos.loadFen(startFen);
+	std::vector<Key> history;
+	bool infinite = false;
+
+	engine.onIteration([&engine](const SearchInfo& info) { send(infoToUci(info, engine.hashfull())); });
+
+	engine.onFinish([&infinite](const SearchInfo& info)
+	{
+		if (!infinite)												// after "go infinite" the move is only sent on "stop"
+			send("bestmove " + (info.pv.empty() ? std::string("0000") : moveToCoordinate(info.pv[0])));
+	});
+
+	std::string line, token;
+
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream iss(line);
+		token.clear();
+		iss >> token;
+
+		if (token == "uci")
+		{
+			send("id name sfml-chess");
+			send("id author the sfml-chess authors");
+			send("option name Hash type spin default 16 min 1 max 4096");
+			send("option name Threads type spin default 1 min 1 max 256");
+			send("option name EvalFile type string default <empty>");
+			send("uciok");
+		}
+		else if (token == "isready")
+			send("readyok");
+		else if (token == "ucinewgame")
+			engine.clearHash();
+		else if (token == "setoption")
+		{
+			std::string name, value;
+			iss >> token >> name >> token;							// name <id> value <x>
+			std::getline(iss >> std::ws, value);					// file names may contain spaces
+
+			if (name == "Hash")
+				engine.setHashSize(size_t(std::atoi(value.c_str())));
+			else if (name == "Threads")
+				engine.setThreads(std::atoi(value.c_str()));
+			else if (name == "EvalFile")
+			{
+				engine.stop();										// the network must not change under a search
+				engine.wait();
+
+				if (value.empty() || value == "<empty>")
+				{
+					nnueUnload();
+					send("info string classical evaluation");
+				}
+				else if (nnueLoad(value))
+					send("info string loaded network " + value);
+			}
+		}
+		else if (token == "position")
+		{
+			engine.stop();
+			engine.wait();
+			setPosition(pos, history, iss);
+		}
+		else if (token == "go")
+		{
+			engine.stop();
+			engine.wait();
+			SearchLimits limits = parseGo(pos, iss, infinite);
+			engine.start(pos, limits, history);
+		}
+		else if (token == "stop" || token == "quit")
+		{
+			engine.stop();
+			engine.wait();
+
+			if (infinite)
+			{
+				infinite = false;
+				SearchInfo info = engine.getResult();
+				send("bestmove " + (info.pv.empty() ? std::string("0000") : moveToCoordinate(info.pv[0])));
+			}
+
+			if (token == "quit")
+				break;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}